@@ -1,7 +1,10 @@
 TEMPLATE = subdirs
 
 SUBDIRS = \
-        src
+        src \
+        tests
+
+tests.depends = src
 
 OTHER_FILES += \
         rpm/nemo-qml-plugin-devicelock.spec
@@ -8,6 +8,7 @@ Source0:    %{name}-%{version}.tar.bz2
 BuildRequires:  pkgconfig(Qt5DBus)
 BuildRequires:  pkgconfig(Qt5Core)
 BuildRequires:  pkgconfig(Qt5Qml)
+BuildRequires:  pkgconfig(Qt5Test)
 BuildRequires:  pkgconfig(glib-2.0)
 BuildRequires:  pkgconfig(keepalive)
 BuildRequires:  pkgconfig(libsystemd)
@@ -46,6 +47,13 @@ Requires:   pkgconfig(nemodbus)
 %description host-devel
 %{summary}.
 
+%package tests
+Summary:    Unit tests for device lock
+Requires:   %{name} = %{version}-%{release}
+
+%description tests
+%{summary}.
+
 %prep
 %setup -q -n %{name}-%{version}
 
@@ -91,3 +99,7 @@ ln -sf ../nemo-devicelock.socket %{buildroot}%{_unitdir}/multi-user.target.wants
 %{_includedir}/nemo-devicelock/host/*.h
 %{_libdir}/libnemodevicelock-host.a
 %{_datadir}/qt5/mkspecs/features/nemo-devicelock-host.prf
+
+%files tests
+%dir /opt/tests/nemo-qml-plugin-devicelock
+/opt/tests/nemo-qml-plugin-devicelock/*
@@ -221,6 +221,7 @@ AuthenticationInput::AuthenticationInput(Type type, QObject *parent)
     , m_settings(SettingsWatcher::instance())
     , m_utilizedMethods()
     , m_authenticatingPid(0)
+    , m_currentAttempts(0)
     , m_status(Idle)
     , m_registered(false)
     , m_active(false)
@@ -299,6 +300,18 @@ int AuthenticationInput::maximumAttempts() const
     return m_settings->maximumAttempts;
 }
 
+/*!
+    \property NemoDeviceLock::AuthenticationInput::currentAttempts
+
+    This property holds the number of incorrect security codes the user has entered since they last
+    authenticated successfully.
+*/
+
+int AuthenticationInput::currentAttempts() const
+{
+    return m_currentAttempts;
+}
+
 /*!
     \property NemoDeviceLock::AuthenticationInput::codeGeneration
 
@@ -640,6 +653,13 @@ void AuthenticationInput::handleError(Error error)
 void AuthenticationInput::connected()
 {
     registerObject();
+
+    subscribeToProperty<int>(QStringLiteral("CurrentAttempts"), [this](int attempts) {
+        if (m_currentAttempts != attempts) {
+            m_currentAttempts = attempts;
+            emit currentAttemptsChanged();
+        }
+    });
 }
 
 }
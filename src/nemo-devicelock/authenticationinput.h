@@ -72,6 +72,7 @@ class NEMODEVICELOCK_EXPORT AuthenticationInput : public QObject, private Connec
     Q_PROPERTY(int minimumCodeLength READ minimumCodeLength CONSTANT)
     Q_PROPERTY(int maximumCodeLength READ maximumCodeLength CONSTANT)
     Q_PROPERTY(int maximumAttempts READ maximumAttempts NOTIFY maximumAttemptsChanged)
+    Q_PROPERTY(int currentAttempts READ currentAttempts NOTIFY currentAttemptsChanged)
     Q_PROPERTY(bool codeInputIsKeyboard READ codeInputIsKeyboard NOTIFY codeInputIsKeyboardChanged)
     Q_PROPERTY(CodeGeneration codeGeneration READ codeGeneration NOTIFY codeGenerationChanged)
 public:
@@ -99,7 +100,8 @@ public:
         SecurityCodeRequiredAfterReboot,
         UnrecognizedFingerLimitExceeded,
         NewSecurityCodeTooShort,
-        NewSecurityCodeTooLong
+        NewSecurityCodeTooLong,
+        SecurityCodeTooWeak
     };
     Q_ENUM(Feedback)
 
@@ -146,6 +148,7 @@ public:
     void setRegistered(bool registered);
 
     int maximumAttempts() const;
+    int currentAttempts() const;
 
     CodeGeneration codeGeneration() const;
 
@@ -165,6 +168,7 @@ signals:
     void authenticatingPidChanged();
     void utilizedMethodsChanged();
     void maximumAttemptsChanged();
+    void currentAttemptsChanged();
     void temporaryLockoutDurationChanged();
     void temporaryLockoutExpirationChanged();
     void codeGenerationChanged();
@@ -202,6 +206,7 @@ private:
     QExplicitlySharedDataPointer<SettingsWatcher> m_settings;
     Authenticator::Methods m_utilizedMethods;
     int m_authenticatingPid;
+    int m_currentAttempts;
     Status m_status;
     bool m_registered;
     bool m_active;
@@ -32,11 +32,65 @@
 
 #include "devicelocksettings.h"
 
+#include "private/logging.h"
 #include "settingswatcher.h"
 
+#include <QSharedPointer>
+
 namespace NemoDeviceLock
 {
 
+namespace {
+
+enum SettingType { IntegerSetting, FlagSetting, BooleanSetting };
+
+struct SettingKey
+{
+    const char *property;
+    const char * const *key;
+    SettingType type;
+};
+
+}
+
+// The properties which may be changed and the configuration keys they're stored in.
+static const SettingKey settingKeys[] = {
+    { "automaticLocking", &SettingsWatcher::automaticLockingKey, IntegerSetting },
+    { "maximumAttempts", &SettingsWatcher::maximumAttemptsKey, IntegerSetting },
+    { "peekingAllowed", &SettingsWatcher::peekingAllowedKey, FlagSetting },
+    { "sideloadingAllowed", &SettingsWatcher::sideloadingAllowedKey, FlagSetting },
+    { "showNotifications", &SettingsWatcher::showNotificationsKey, FlagSetting },
+    { "inputIsKeyboard", &SettingsWatcher::inputIsKeyboardKey, BooleanSetting }
+};
+
+static const SettingKey *findSettingKey(const QString &property)
+{
+    for (const SettingKey &setting : settingKeys) {
+        if (property == QLatin1String(setting.property)) {
+            return &setting;
+        }
+    }
+    return nullptr;
+}
+
+static QString settingPath(const SettingKey &setting)
+{
+    return QStringLiteral("/desktop/nemo/devicelock/") + QString::fromUtf8(*setting.key);
+}
+
+static QVariant settingValue(const SettingKey &setting, const QVariant &value)
+{
+    switch (setting.type) {
+    case IntegerSetting:
+        return value.toInt();
+    case FlagSetting:
+        return value.toBool() ? 1 : 0;
+    case BooleanSetting:
+        return value.toBool();
+    }
+    return value;
+}
+
 /*!
     \class NemoDeviceLock::DeviceLockSettings
     \brief The DeviceLockSettings class provides access to settings for device lock.
@@ -51,7 +105,8 @@ DeviceLockSettings::DeviceLockSettings(QObject *parent)
     , ConnectionClient(
           this,
           QStringLiteral("/devicelock/settings"),
-          QStringLiteral("org.nemomobile.devicelock.DeviceLock.Settings"))
+          QStringLiteral("org.nemomobile.devicelock.DeviceLock.Settings"),
+          LazyConnection)
     , m_authorization(m_localPath, path())
     , m_authorizationAdaptor(&m_authorization, this)
     , m_settings(SettingsWatcher::instance())
@@ -131,7 +186,7 @@ int DeviceLockSettings::automaticLocking() const
 
 void DeviceLockSettings::setAutomaticLocking(const QVariant &authenticationToken, int value)
 {
-    changeSetting(authenticationToken, QString::fromUtf8(SettingsWatcher::automaticLockingKey), value);
+    changeSetting(authenticationToken, "automaticLocking", value);
 }
 
 /*!
@@ -155,7 +210,7 @@ int DeviceLockSettings::maximumAttempts() const
 
 void DeviceLockSettings::setMaximumAttempts(const QVariant &authenticationToken, int value)
 {
-    changeSetting(authenticationToken, QString::fromUtf8(SettingsWatcher::maximumAttemptsKey), value);
+    changeSetting(authenticationToken, "maximumAttempts", value);
 }
 
 /*!
@@ -178,7 +233,7 @@ bool DeviceLockSettings::peekingAllowed() const
 
 void DeviceLockSettings::setPeekingAllowed(const QVariant &authenticationToken, bool value)
 {
-    changeSetting(authenticationToken, QString::fromUtf8(SettingsWatcher::peekingAllowedKey), value ? 1 : 0);
+    changeSetting(authenticationToken, "peekingAllowed", value);
 }
 
 /*!
@@ -201,7 +256,7 @@ bool DeviceLockSettings::sideloadingAllowed() const
 
 void DeviceLockSettings::setSideloadingAllowed(const QVariant &authenticationToken, bool value)
 {
-    changeSetting(authenticationToken, QString::fromUtf8(SettingsWatcher::sideloadingAllowedKey), value ? 1 : 0);
+    changeSetting(authenticationToken, "sideloadingAllowed", value);
 }
 
 /*!
@@ -224,7 +279,7 @@ bool DeviceLockSettings::showNotifications() const
 
 void DeviceLockSettings::setShowNotifications(const QVariant &authenticationToken, bool value)
 {
-    changeSetting(authenticationToken, QString::fromUtf8(SettingsWatcher::showNotificationsKey), value ? 1 : 0);
+    changeSetting(authenticationToken, "showNotifications", value);
 }
 
 /*!
@@ -247,9 +302,71 @@ bool DeviceLockSettings::inputIsKeyboard() const
 
 void DeviceLockSettings::setInputIsKeyboard(const QVariant &authenticationToken, bool value)
 {
-    changeSetting(authenticationToken, QString::fromUtf8(SettingsWatcher::inputIsKeyboardKey), value);
+    changeSetting(authenticationToken, "inputIsKeyboard", value);
 }
 
+/*!
+    Sets new values for multiple settings at once.
+
+    The \a settings map is keyed by property name and may contain any of \l automaticLocking,
+    \l maximumAttempts, \l peekingAllowed, \l sideloadingAllowed, \l showNotifications and
+    \l inputIsKeyboard.  All values are applied together with a single update of the settings.
+
+    The settings authorization challenge code must be authenticated before this is called and the
+    \a authenticationToken produced passed as an argument.
+*/
+
+void DeviceLockSettings::changeSettings(const QVariant &authenticationToken, const QVariantMap &settings)
+{
+    if (m_authorization.status() != Authorization::ChallengeIssued) {
+        return;
+    }
+
+    QVariantMap values;
+    for (auto it = settings.begin(); it != settings.end(); ++it) {
+        if (const SettingKey *setting = findSettingKey(it.key())) {
+            values.insert(settingPath(*setting), settingValue(*setting, it.value()));
+        } else {
+            qCWarning(devicelock, "Unknown device lock setting %s", qPrintable(it.key()));
+        }
+    }
+
+    if (values.isEmpty()) {
+        emit changeSettingsError();
+        return;
+    }
+
+    auto response = call(QStringLiteral("ChangeSettings"), m_localPath, authenticationToken, values);
+
+    response->onError([this, authenticationToken, values](const QDBusError &error) {
+        if (error.type() != QDBusError::NotSupported && error.type() != QDBusError::UnknownMethod) {
+            emit changeSettingsError();
+            return;
+        }
+
+        // Fall back to changing settings individually if the host doesn't support the batch call,
+        // reporting an error once if any of them fail.
+        const QSharedPointer<bool> failed(new bool(false));
+
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            auto fallback = call(QStringLiteral("ChangeSetting"), m_localPath, authenticationToken, it.key(), it.value());
+
+            fallback->onError([this, failed](const QDBusError &) {
+                if (!*failed) {
+                    *failed = true;
+                    emit changeSettingsError();
+                }
+            });
+        }
+    });
+}
+
+/*!
+    \signal NemoDeviceLock::DeviceLockSettings::changeSettingsError()
+
+    Signals that an error occurred when changing one or more settings.
+*/
+
 /*!
     \property NemoDeviceLock::DeviceLockSettings::currentCodeIsDigitOnly
 
@@ -337,14 +454,20 @@ qint64 DeviceLockSettings::temporaryLockTimeout() const
 }
 
 void DeviceLockSettings::changeSetting(
-        const QVariant &authenticationToken, const QString &key, const QVariant &value)
+        const QVariant &authenticationToken, const char *property, const QVariant &value)
 {
-    if (m_authorization.status() == Authorization::ChallengeIssued) {
-        call(QStringLiteral("ChangeSetting"),
+    const SettingKey * const setting = findSettingKey(QLatin1String(property));
+
+    if (setting && m_authorization.status() == Authorization::ChallengeIssued) {
+        auto response = call(QStringLiteral("ChangeSetting"),
                     m_localPath,
                     authenticationToken,
-                    QStringLiteral("/desktop/nemo/devicelock/") + key,
-                    value);
+                    settingPath(*setting),
+                    settingValue(*setting, value));
+
+        response->onError([this](const QDBusError &) {
+            emit changeSettingsError();
+        });
     }
 }
 
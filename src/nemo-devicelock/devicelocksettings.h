@@ -82,6 +82,8 @@ public:
     bool inputIsKeyboard() const;
     Q_INVOKABLE void setInputIsKeyboard(const QVariant &authenticationToken, bool value);
 
+    Q_INVOKABLE void changeSettings(const QVariant &authenticationToken, const QVariantMap &settings);
+
     bool currentCodeIsDigitOnly() const;
     int currentCodeLength() const;
     int minimumCodeLength() const;
@@ -109,9 +111,11 @@ signals:
     void absoluteMaximumAttemptsChanged();
     void temporaryLockTimeoutChanged();
 
+    void changeSettingsError();
+
 private:
     inline void changeSetting(
-            const QVariant &authenticationToken, const QString &key, const QVariant &value);
+            const QVariant &authenticationToken, const char *property, const QVariant &value);
     inline void connected();
 
     ClientAuthorization m_authorization;
@@ -59,7 +59,8 @@ DeviceReset::DeviceReset(QObject *parent)
     , ConnectionClient(
           this,
           QStringLiteral("/devicereset"),
-          QStringLiteral("org.nemomobile.devicelock.DeviceReset"))
+          QStringLiteral("org.nemomobile.devicelock.DeviceReset"),
+          LazyConnection)
     , m_authorization(m_localPath, path())
     , m_authorizationAdaptor(&m_authorization, this)
     , m_settings(SettingsWatcher::instance())
@@ -140,7 +140,7 @@ void EncryptionSettings::encryptHome(const QVariant &authenticationToken)
 
 void EncryptionSettings::connected()
 {
-    void registerObject();
+    registerObject();
 
     subscribeToProperty<bool>(QStringLiteral("Supported"), [this](bool supported) {
         m_supported = supported;
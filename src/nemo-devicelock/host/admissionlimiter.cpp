@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "admissionlimiter.h"
+
+namespace NemoDeviceLock
+{
+
+AdmissionLimiter::AdmissionLimiter(int rate, int burst)
+    : m_rate(rate)
+    , m_burst(burst)
+    , m_credit(qint64(burst) * 1000)
+{
+}
+
+/*
+    Admits a connection if there is credit for one after the \a elapsed milliseconds since the
+    previous attempt.
+*/
+bool AdmissionLimiter::admit(qint64 elapsed)
+{
+    m_credit = qMin<qint64>(qint64(m_burst) * 1000, m_credit + elapsed * m_rate);
+
+    if (m_credit < 1000) {
+        return false;
+    }
+
+    m_credit -= 1000;
+
+    return true;
+}
+
+/*
+    Returns the number of milliseconds until there will be credit to admit another connection.
+*/
+int AdmissionLimiter::delay() const
+{
+    return m_credit < 1000 ? int((1000 - m_credit + m_rate - 1) / m_rate) : 0;
+}
+
+}
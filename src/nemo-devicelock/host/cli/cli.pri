@@ -9,7 +9,8 @@ PUBLIC_HEADERS += \
         $$PWD/cliencryptionsettings.h
 
 HEADERS +=  \
-        $$PWD/lockcodewatcher.h
+        $$PWD/lockcodewatcher.h \
+        $$PWD/pluginworker.h
 
 SOURCES += \
         $$PWD/cliauthenticator.cpp \
@@ -17,4 +18,5 @@ SOURCES += \
         $$PWD/clidevicelocksettings.cpp \
         $$PWD/clidevicereset.cpp \
         $$PWD/cliencryptionsettings.cpp \
-        $$PWD/lockcodewatcher.cpp
+        $$PWD/lockcodewatcher.cpp \
+        $$PWD/pluginworker.cpp
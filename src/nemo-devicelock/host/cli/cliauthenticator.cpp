@@ -45,7 +45,7 @@ CliAuthenticator::CliAuthenticator(QObject *parent)
 {
     connect(m_watcher.data(), &LockCodeWatcher::securityCodeSetChanged,
             this, &CliAuthenticator::availableMethodsChanged);
-    connect(m_watcher.data(), &LockCodeWatcher::securityCodeSetChanged,
+    connect(m_watcher.data(), &LockCodeWatcher::availabilityChanged,
             this, &CliAuthenticator::availabilityChanged);
 }
 
@@ -67,33 +67,38 @@ Authenticator::Methods CliAuthenticator::availableMethods() const
 
 HostAuthenticationInput::Availability CliAuthenticator::availability(QVariantMap *) const
 {
-    if (m_watcher->securityCodeSet()) {
-        const int maximum = maximumAttempts();
-        const int attempts = currentAttempts();
-
-        if (maximum > 0 && attempts >= maximum) {
-            return CodeEntryLockedPermanent;
-        } else {
-            return CanAuthenticate;
-        }
-    } else {
-        return AuthenticationNotRequired;
-    }
+    return m_watcher->availability();
 }
 
 int CliAuthenticator::checkCode(const QString &code)
 {
-    return m_watcher->runPlugin(QStringList() << QStringLiteral("--check-code") << code);
+    m_watcher->runPlugin(QStringList() << QStringLiteral("--check-code") << code, this, [this, code](int result) {
+        // The code is the authentication token, keep it available until the result is handled.
+        m_securityCode = code;
+        checkCodeFinished(result);
+        m_securityCode.clear();
+    });
+
+    return Evaluating;
 }
 
 int CliAuthenticator::setCode(const QString &oldCode, const QString &newCode)
 {
-    return m_watcher->runPlugin(QStringList() << QStringLiteral("--set-code") << oldCode << newCode);
+    const int result = m_watcher->runPlugin(QStringList() << QStringLiteral("--set-code") << oldCode << newCode);
+    if (result == Success) {
+        m_watcher->setSecurityCodeSet(true);
+    }
+    return result;
 }
 
 bool CliAuthenticator::clearCode(const QString &code)
 {
-    return m_watcher->runPlugin(QStringList() << QStringLiteral("--clear-code") << code) == Success;
+    if (m_watcher->runPlugin(QStringList() << QStringLiteral("--clear-code") << code) == Success) {
+        m_watcher->setSecurityCodeSet(false);
+        return true;
+    } else {
+        return false;
+    }
 }
 
 void CliAuthenticator::enterSecurityCode(const QString &code)
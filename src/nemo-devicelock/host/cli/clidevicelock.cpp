@@ -44,7 +44,7 @@ CliDeviceLock::CliDeviceLock(QObject *parent)
     : MceDeviceLock(Authenticator::SecurityCode, parent)
     , m_watcher(LockCodeWatcher::instance())
 {
-    connect(m_watcher.data(), &LockCodeWatcher::securityCodeSetChanged,
+    connect(m_watcher.data(), &LockCodeWatcher::availabilityChanged,
             this, &CliDeviceLock::availabilityChanged);
 
     init();
@@ -56,18 +56,7 @@ CliDeviceLock::~CliDeviceLock()
 
 HostAuthenticationInput::Availability CliDeviceLock::availability(QVariantMap *) const
 {
-    if (m_watcher->securityCodeSet()) {
-        const int maximum = maximumAttempts();
-        const int attempts = currentAttempts();
-
-        if (maximum > 0 && attempts >= maximum) {
-            return CodeEntryLockedPermanent;
-        } else {
-            return CanAuthenticate;
-        }
-    } else {
-        return AuthenticationNotRequired;
-    }
+    return m_watcher->availability();
 }
 
 int CliDeviceLock::checkCode(const QString &code)
@@ -77,12 +66,40 @@ int CliDeviceLock::checkCode(const QString &code)
 
 int CliDeviceLock::setCode(const QString &oldCode, const QString &newCode)
 {
-    return m_watcher->runPlugin(QStringList() << QStringLiteral("--set-code") << oldCode << newCode);
+    const int result = m_watcher->runPlugin(QStringList() << QStringLiteral("--set-code") << oldCode << newCode);
+    if (result == Success) {
+        m_watcher->setSecurityCodeSet(true);
+    }
+    return result;
 }
 
 int CliDeviceLock::unlockWithCode(const QString &code)
 {
-    return m_watcher->runPlugin(QStringList() << QStringLiteral("--unlock") << code);
+    m_watcher->runPlugin(QStringList() << QStringLiteral("--unlock") << code, this, [this](int result) {
+        unlockFinished(result, Authenticator::SecurityCode);
+    });
+
+    return Evaluating;
+}
+
+bool CliDeviceLock::canSetCodeAndUnlock() const
+{
+    return m_watcher->hasPluginCapability(QStringLiteral("set-code-and-unlock"));
+}
+
+int CliDeviceLock::setCodeAndUnlock(const QString &oldCode, const QString &newCode)
+{
+    m_watcher->runPlugin(QStringList()
+                << QStringLiteral("--set-code-and-unlock")
+                << oldCode
+                << newCode, this, [this](int result) {
+        if (result == Success) {
+            m_watcher->setSecurityCodeSet(true);
+        }
+        setCodeAndUnlockFinished(result);
+    });
+
+    return Evaluating;
 }
 
 }
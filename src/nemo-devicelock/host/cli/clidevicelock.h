@@ -55,6 +55,9 @@ public:
     int setCode(const QString &oldCode, const QString &newCode) override;
     int unlockWithCode(const QString &code) override;
 
+    bool canSetCodeAndUnlock() const override;
+    int setCodeAndUnlock(const QString &oldCode, const QString &newCode) override;
+
 private:
     QExplicitlySharedDataPointer<LockCodeWatcher> m_watcher;
     bool m_unlocking;
@@ -54,12 +54,60 @@ CliDeviceLockSettings::~CliDeviceLockSettings()
 void CliDeviceLockSettings::changeSetting(
         const QString &, const QVariant &authenticationToken, const QString &key, const QVariant &value)
 {
-    if (m_watcher->runPlugin(QStringList()
+    HostObject::setDelayedReply(true);
+
+    const QDBusConnection connection = HostObject::connection();
+    const QDBusMessage message = HostObject::message();
+
+    m_watcher->runPlugin(QStringList()
                 << QStringLiteral("--set-config-key")
                 << authenticationToken.toString()
                 << key
-                << value.toString()) != HostAuthenticationInput::Success) {
-        QDBusContext::sendErrorReply(QDBusError::InternalError);
+                << value.toString(), this, [connection, message](int result) {
+        connection.send(result == HostAuthenticationInput::Success
+                ? message.createReply()
+                : message.createErrorReply(QDBusError::InternalError, QString()));
+    });
+}
+
+void CliDeviceLockSettings::changeSettings(
+        const QString &, const QVariant &authenticationToken, const QVariantMap &settings)
+{
+    HostObject::setDelayedReply(true);
+
+    const QDBusConnection connection = HostObject::connection();
+    const QDBusMessage message = HostObject::message();
+
+    const auto reply = [connection, message](int result) {
+        connection.send(result == HostAuthenticationInput::Success
+                ? message.createReply()
+                : message.createErrorReply(QDBusError::InternalError, QString()));
+    };
+
+    QStringList keyValues;
+    for (auto it = settings.begin(); it != settings.end(); ++it) {
+        keyValues << it.key() << it.value().toString();
+    }
+
+    if (keyValues.isEmpty()) {
+        reply(HostAuthenticationInput::Success);
+    } else if (m_watcher->hasPluginCapability(QStringLiteral("set-config-keys"))) {
+        // The plugin writes all keys with a single update of the settings file.
+        m_watcher->runPlugin(QStringList()
+                    << QStringLiteral("--set-config-keys")
+                    << authenticationToken.toString()
+                    << keyValues, this, reply);
+    } else if (keyValues.count() == 2) {
+        m_watcher->runPlugin(QStringList()
+                    << QStringLiteral("--set-config-key")
+                    << authenticationToken.toString()
+                    << keyValues, this, reply);
+    } else {
+        // Setting the keys one at a time could leave only some of them changed if one fails.  This
+        // isn't NotSupported as that would have the client fall back to doing exactly that.
+        connection.send(message.createErrorReply(
+                    QDBusError::Failed,
+                    QStringLiteral("The plugin can't change multiple settings at once")));
     }
 }
 
@@ -54,6 +54,10 @@ public:
             const QVariant &authenticationToken,
             const QString &key,
             const QVariant &value) override;
+    void changeSettings(
+            const QString &requestor,
+            const QVariant &authenticationToken,
+            const QVariantMap &settings) override;
 
 private:
     QExplicitlySharedDataPointer<LockCodeWatcher> m_watcher;
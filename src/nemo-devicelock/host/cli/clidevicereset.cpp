@@ -64,9 +64,16 @@ void CliDeviceReset::clearDevice(
         arguments << QStringLiteral("--wipe");
     }
 
-    if (m_watcher->runPlugin(arguments) != HostAuthenticationInput::Success) {
-        QDBusContext::sendErrorReply(QDBusError::InternalError);
-    }
+    HostObject::setDelayedReply(true);
+
+    const QDBusConnection connection = HostObject::connection();
+    const QDBusMessage message = HostObject::message();
+
+    m_watcher->runPlugin(arguments, this, [connection, message](int result) {
+        connection.send(result == HostAuthenticationInput::Success
+                ? message.createReply()
+                : message.createErrorReply(QDBusError::InternalError, QString()));
+    });
 }
 
 }
@@ -65,11 +65,18 @@ bool CliEncryptionSettings::isSupported() const
 
 void CliEncryptionSettings::encryptHome(const QString &, const QVariant &authenticationToken)
 {
-    if (m_watcher->runPlugin(QStringList()
+    HostObject::setDelayedReply(true);
+
+    const QDBusConnection connection = HostObject::connection();
+    const QDBusMessage message = HostObject::message();
+
+    m_watcher->runPlugin(QStringList()
                 << QStringLiteral("--encrypt-home")
-                << authenticationToken.toString()) != HostAuthenticationInput::Success) {
-        QDBusContext::sendErrorReply(QDBusError::InternalError);
-    }
+                << authenticationToken.toString(), this, [connection, message](int result) {
+        connection.send(result == HostAuthenticationInput::Success
+                ? message.createReply()
+                : message.createErrorReply(QDBusError::InternalError, QString()));
+    });
 }
 
 }
@@ -33,10 +33,13 @@
 #include "lockcodewatcher.h"
 
 #include "cliauthenticator.h"
+#include "pluginworker.h"
+#include "settingswatcher.h"
 
 #include <QDBusConnection>
 #include <QDBusMessage>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QJsonArray>
@@ -45,10 +48,19 @@
 #include <QProcess>
 #include <QSettings>
 #include <QStandardPaths>
+#include <QTimer>
+#include <QVarLengthArray>
+
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
 
 namespace NemoDeviceLock
 {
 
+// How long a synchronous one-shot invocation of the plugin may run before it is presumed hung.
+static const int processTimeout = 10000;
+
 static QString pluginName()
 {
     static const QString pluginName = []() {
@@ -65,20 +77,88 @@ static QString pluginName()
     return pluginName;
 }
 
+static QStringList pluginCapabilities()
+{
+    static const QStringList pluginCapabilities = []() {
+        QSettings settings(QStringLiteral("/usr/share/lipstick/devicelock/devicelock.conf"), QSettings::IniFormat);
+        return settings.value(QStringLiteral("DeviceLock/pluginCapabilities")).toStringList();
+    }();
+
+    return pluginCapabilities;
+}
+
+static QString securityCodeStore()
+{
+    QSettings settings(QStringLiteral("/usr/share/lipstick/devicelock/devicelock.conf"), QSettings::IniFormat);
+    return settings.value(QStringLiteral("DeviceLock/securityCodeStore")).toString();
+}
+
 LockCodeWatcher *LockCodeWatcher::sharedInstance = nullptr;
 
 LockCodeWatcher::LockCodeWatcher(QObject *parent)
     : QObject(parent)
+    , m_settings(SettingsWatcher::instance(SettingsWatcher::Publisher))
+    , m_worker(nullptr)
+    , m_storeNotifier(nullptr)
+    , m_storeWatch(-1)
     , m_pluginExists(QFile::exists(pluginName()))
     , m_securityCodeSet(false)
     , m_codeSetInvalidated(true)
+    , m_availability(HostAuthenticationInput::AuthenticationNotRequired)
+    , m_notifiedAvailability(HostAuthenticationInput::AuthenticationNotRequired)
+    , m_availabilityInvalidated(true)
+    , m_availabilityUpdateQueued(false)
+    , m_refreshing(false)
+    , m_refreshQueued(false)
 {
     Q_ASSERT(!sharedInstance);
     sharedInstance = this;
+
+    connect(this, &LockCodeWatcher::securityCodeSetChanged, this, [this]() {
+        m_availabilityInvalidated = true;
+        updateAvailability();
+    });
+    connect(m_settings.data(), &SettingsWatcher::maximumAttemptsChanged,
+            this, &LockCodeWatcher::invalidateAvailability);
+    connect(m_settings.data(), &SettingsWatcher::currentAttemptsChanged,
+            this, &LockCodeWatcher::invalidateAvailability);
+
+    // The daemon updates the cached state itself when it sets or clears the code, watching the
+    // plugin's store catches changes made by other means.
+    const QString store = securityCodeStore();
+    if (!store.isEmpty()) {
+        const QFileInfo storeInfo(store);
+        const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+        if (fd >= 0) {
+            m_storeName = QFile::encodeName(storeInfo.fileName());
+            m_storeWatch = inotify_add_watch(
+                        fd,
+                        QFile::encodeName(storeInfo.absolutePath()).constData(),
+                        IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_CLOSE_WRITE | IN_DELETE);
+
+            if (m_storeWatch >= 0) {
+                m_storeNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+                connect(m_storeNotifier, &QSocketNotifier::activated,
+                        this, &LockCodeWatcher::securityCodeStoreChanged);
+            } else {
+                qCWarning(daemon, "DeviceLock: Failed to watch the security code store %s", qPrintable(store));
+                ::close(fd);
+            }
+        }
+    }
+
+    if (m_pluginExists && pluginCapabilities().contains(QStringLiteral("worker"))) {
+        m_worker = new PluginWorker(pluginName(), this);
+    }
 }
 
 LockCodeWatcher::~LockCodeWatcher()
 {
+    if (m_storeNotifier) {
+        ::close(m_storeNotifier->socket());
+    }
+
     sharedInstance = nullptr;
 }
 
@@ -87,6 +167,11 @@ LockCodeWatcher *LockCodeWatcher::instance()
     return sharedInstance ? sharedInstance : new LockCodeWatcher;
 }
 
+bool LockCodeWatcher::hasPluginCapability(const QString &capability) const
+{
+    return m_pluginExists && pluginCapabilities().contains(capability);
+}
+
 bool LockCodeWatcher::securityCodeSet() const
 {
     if (m_codeSetInvalidated) {
@@ -98,35 +183,216 @@ bool LockCodeWatcher::securityCodeSet() const
     return m_securityCodeSet;
 }
 
-void LockCodeWatcher::invalidateSecurityCodeSet()
+void LockCodeWatcher::setSecurityCodeSet(bool set)
 {
-    if (!m_codeSetInvalidated) {
-        m_codeSetInvalidated = true;
+    const bool changed = m_codeSetInvalidated || m_securityCodeSet != set;
+
+    m_codeSetInvalidated = false;
+    m_securityCodeSet = set;
 
+    if (changed) {
         emit securityCodeSetChanged();
     }
 }
 
+void LockCodeWatcher::invalidateSecurityCodeSet()
+{
+    if (m_codeSetInvalidated) {
+        // Nothing has read the state yet, it will be queried on first use.
+        return;
+    } else if (m_refreshing) {
+        m_refreshQueued = true;
+        return;
+    }
+
+    m_refreshing = true;
+
+    runPlugin(QStringList() << QStringLiteral("--is-set") << QStringLiteral("lockcode"), this, [this](int result) {
+        m_refreshing = false;
+
+        if (m_refreshQueued) {
+            m_refreshQueued = false;
+            invalidateSecurityCodeSet();
+        } else {
+            setSecurityCodeSet(result == HostAuthenticationInput::Success);
+        }
+    });
+}
+
+HostAuthenticationInput::Availability LockCodeWatcher::availability() const
+{
+    if (m_availabilityInvalidated) {
+        m_availabilityInvalidated = false;
+        m_availability = evaluateAvailability();
+    }
+    return m_availability;
+}
+
+HostAuthenticationInput::Availability LockCodeWatcher::evaluateAvailability() const
+{
+    if (securityCodeSet()) {
+        const int maximum = m_settings->maximumAttempts;
+        const int attempts = m_settings->currentAttempts;
+
+        if (maximum > 0 && attempts >= maximum) {
+            return HostAuthenticationInput::CodeEntryLockedPermanent;
+        } else {
+            return HostAuthenticationInput::CanAuthenticate;
+        }
+    } else {
+        return HostAuthenticationInput::AuthenticationNotRequired;
+    }
+}
+
+void LockCodeWatcher::invalidateAvailability()
+{
+    m_availabilityInvalidated = true;
+
+    // Anything reading the availability gets the current value immediately, but the change is
+    // signalled later so that an attempt count updated while a result is being handled doesn't
+    // trigger handlers from within that handler.
+    if (!m_availabilityUpdateQueued) {
+        m_availabilityUpdateQueued = true;
+
+        QTimer::singleShot(0, this, &LockCodeWatcher::updateAvailability);
+    }
+}
+
+void LockCodeWatcher::updateAvailability()
+{
+    m_availabilityUpdateQueued = false;
+
+    const auto availability = LockCodeWatcher::availability();
+    if (m_notifiedAvailability != availability) {
+        m_notifiedAvailability = availability;
+        emit availabilityChanged();
+    }
+}
+
 int LockCodeWatcher::runPlugin(const QStringList &arguments) const
 {
     if (!m_pluginExists) {
         return HostAuthenticationInput::Failure;
     }
 
+    QElapsedTimer timer;
+    timer.start();
+
+    int result;
+    if (m_worker && m_worker->call(arguments, &result)) {
+        qCDebug(daemon, "DeviceLock: Plugin worker completed %s in %lld ms",
+                    qPrintable(arguments.value(0)), timer.elapsed());
+    } else {
+        result = runPluginProcess(arguments);
+
+        qCDebug(daemon, "DeviceLock: Plugin process completed %s in %lld ms",
+                    qPrintable(arguments.value(0)), timer.elapsed());
+    }
+
+    return result;
+}
+
+void LockCodeWatcher::runPlugin(
+        const QStringList &arguments, QObject *context, const std::function<void(int result)> &callback)
+{
+    if (!m_pluginExists) {
+        QTimer::singleShot(0, context, [callback]() {
+            callback(HostAuthenticationInput::Failure);
+        });
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const QString command = arguments.value(0);
+
+    if (m_worker && m_worker->start()) {
+        m_worker->call(arguments, context, [callback, command, timer](int result) {
+            qCDebug(daemon, "DeviceLock: Plugin worker completed %s in %lld ms",
+                        qPrintable(command), timer.elapsed());
+
+            callback(result);
+        });
+    } else {
+        const QPointer<QObject> receiver = context;
+        QProcess * const process = new QProcess(this);
+
+        connect(process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+                this, [process, receiver, callback, command, timer](int exitCode, QProcess::ExitStatus exitStatus) {
+            process->deleteLater();
+
+            qCDebug(daemon, "DeviceLock: Plugin process completed %s in %lld ms",
+                        qPrintable(command), timer.elapsed());
+
+            if (receiver) {
+                callback(exitStatus == QProcess::NormalExit
+                        ? -exitCode
+                        : HostAuthenticationInput::Failure);
+            }
+        });
+        connect(process, &QProcess::errorOccurred, this, [process, receiver, callback](QProcess::ProcessError error) {
+            // A process which fails to start won't emit finished().
+            if (error == QProcess::FailedToStart) {
+                process->deleteLater();
+
+                if (receiver) {
+                    callback(HostAuthenticationInput::Failure);
+                }
+            }
+        });
+
+        process->start(pluginName(), arguments);
+    }
+}
+
+int LockCodeWatcher::runPluginProcess(const QStringList &arguments) const
+{
     QProcess process;
     process.start(pluginName(), arguments);
-    process.waitForFinished(-1);
+
+    if (!process.waitForFinished(processTimeout)) {
+        qCWarning(daemon, "DeviceLock: Lock code plugin didn't complete %s within %d ms, killing it",
+                    qPrintable(arguments.value(0)), processTimeout);
+
+        process.kill();
+        process.waitForFinished(1000);
+
+        return HostAuthenticationInput::Failure;
+    }
 
     return process.exitStatus() == QProcess::NormalExit
             ? -process.exitCode()
             : HostAuthenticationInput::Failure;
 }
 
-void LockCodeWatcher::securityCodeSetInvalidated()
+void LockCodeWatcher::securityCodeStoreChanged()
 {
-    if (!m_codeSetInvalidated) {
-        m_codeSetInvalidated = true;
-        emit securityCodeSetChanged();
+    const int fd = m_storeNotifier->socket();
+
+    int bufferSize = 0;
+    ioctl(fd, FIONREAD, (char *) &bufferSize);
+    QVarLengthArray<char, 4096> buffer(bufferSize);
+
+    bufferSize = read(fd, buffer.data(), bufferSize);
+    char *at = buffer.data();
+    char * const end = at + qMax(0, bufferSize);
+
+    bool changed = false;
+
+    struct inotify_event *pevent = 0;
+    for (;at < end; at += sizeof(inotify_event) + pevent->len) {
+        pevent = reinterpret_cast<inotify_event *>(at);
+
+        if (pevent->wd == m_storeWatch
+                && pevent->len > 0
+                && qstrcmp(pevent->name, m_storeName.constData()) == 0) {
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        invalidateSecurityCodeSet();
     }
 }
 
@@ -33,16 +33,23 @@
 #ifndef NEMODEVICELOCK_LOCKCODEWATCHER_H
 #define NEMODEVICELOCK_LOCKCODEWATCHER_H
 
+#include <nemo-devicelock/host/hostauthenticationinput.h>
+
 #include <QObject>
 #include <QDateTime>
 #include <QPointer>
 #include <QProcess>
 #include <QSharedData>
+#include <QSocketNotifier>
 #include <QVector>
 
+#include <functional>
+
 namespace NemoDeviceLock
 {
 
+class PluginWorker;
+class SettingsWatcher;
 class LockCodeWatcher : public QObject, public QSharedData
 {
     Q_OBJECT
@@ -51,23 +58,46 @@ public:
 
     static LockCodeWatcher *instance();
 
+    bool hasPluginCapability(const QString &capability) const;
+
     bool securityCodeSet() const;
+    void setSecurityCodeSet(bool set);
     void invalidateSecurityCodeSet();
 
+    HostAuthenticationInput::Availability availability() const;
+
     int runPlugin(const QStringList &arguments) const;
+    void runPlugin(const QStringList &arguments, QObject *context, const std::function<void(int result)> &callback);
 
 signals:
     void securityCodeSetChanged();
+    void availabilityChanged();
 
 private slots:
-    void securityCodeSetInvalidated();
+    void securityCodeStoreChanged();
+    void invalidateAvailability();
+    void updateAvailability();
 
 private:
     explicit LockCodeWatcher(QObject *parent = nullptr);
 
+    int runPluginProcess(const QStringList &arguments) const;
+    HostAuthenticationInput::Availability evaluateAvailability() const;
+
+    QExplicitlySharedDataPointer<SettingsWatcher> m_settings;
+    PluginWorker *m_worker;
+    QSocketNotifier *m_storeNotifier;
+    QByteArray m_storeName;
+    int m_storeWatch;
     const bool m_pluginExists;
     mutable bool m_securityCodeSet;
     mutable bool m_codeSetInvalidated;
+    mutable HostAuthenticationInput::Availability m_availability;
+    HostAuthenticationInput::Availability m_notifiedAvailability;
+    mutable bool m_availabilityInvalidated;
+    bool m_availabilityUpdateQueued;
+    bool m_refreshing;
+    bool m_refreshQueued;
 
     static LockCodeWatcher *sharedInstance;
 };
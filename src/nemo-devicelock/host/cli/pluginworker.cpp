@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "pluginworker.h"
+
+#include <nemo-devicelock/host/hostauthenticationinput.h>
+
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+#include <QTimer>
+#include <QtEndian>
+
+namespace NemoDeviceLock
+{
+
+// The number of consecutive times the worker may fail to start before callers are permanently
+// directed to the one-shot invocation instead.
+static const int maximumStartFailures = 3;
+
+// How long a synchronous call waits for the worker to start, and to complete any one request,
+// before it is presumed hung and restarted.
+static const int startTimeout = 5000;
+static const int synchronousTimeout = 10000;
+
+PluginWorker::PluginWorker(const QString &program, QObject *parent)
+    : QObject(parent)
+    , m_program(program)
+    , m_startFailures(0)
+    , m_synchronousCalls(0)
+    , m_repliesReceived(0)
+{
+    m_process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+    connect(&m_process, &QProcess::readyReadStandardOutput, this, &PluginWorker::readReplies);
+    connect(&m_process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+            this, &PluginWorker::processFinished);
+}
+
+PluginWorker::~PluginWorker()
+{
+    if (m_process.state() != QProcess::NotRunning) {
+        // Closing the write channel signals the plugin to exit, give it a moment to do so before
+        // resorting to a kill.
+        m_process.closeWriteChannel();
+        if (!m_process.waitForFinished(1000)) {
+            m_process.kill();
+            m_process.waitForFinished(-1);
+        }
+    }
+}
+
+bool PluginWorker::start()
+{
+    if (m_process.state() == QProcess::Running) {
+        return true;
+    } else if (m_startFailures >= maximumStartFailures) {
+        return false;
+    }
+
+    m_buffer.clear();
+
+    m_process.start(m_program, QStringList() << QStringLiteral("--worker"));
+
+    if (m_process.waitForStarted(startTimeout)) {
+        m_startFailures = 0;
+
+        qCDebug(daemon, "DeviceLock: Started lock code plugin worker, pid %lld", m_process.processId());
+
+        return true;
+    }
+
+    if (m_process.state() != QProcess::NotRunning) {
+        m_process.kill();
+        m_process.waitForFinished(1000);
+    }
+
+    if (++m_startFailures >= maximumStartFailures) {
+        qCWarning(daemon, "DeviceLock: Failed to start the lock code plugin worker, falling back to one-shot invocations. %s",
+                    qPrintable(m_process.errorString()));
+    } else {
+        qCWarning(daemon, "DeviceLock: Failed to start the lock code plugin worker. %s",
+                    qPrintable(m_process.errorString()));
+    }
+
+    return false;
+}
+
+bool PluginWorker::call(const QStringList &arguments, int *result)
+{
+    if (!start()) {
+        return false;
+    }
+
+    // Replies are delivered in order so any outstanding asynchronous requests will complete
+    // before this one does.  The reply state is shared with the callback so it remains valid
+    // if the wait is abandoned before the worker replies.
+    const QSharedPointer<QPair<bool, int>> reply(new QPair<bool, int>(false, HostAuthenticationInput::Failure));
+
+    m_requests.enqueue({ this, [reply](int result) {
+        reply->first = true;
+        reply->second = result;
+    }, true });
+
+    sendRequest(arguments);
+
+    ++m_synchronousCalls;
+
+    // Requests queued ahead of this one are allowed their own time to complete, the timeout
+    // restarts with every reply so only a single request taking too long is treated as a hang.
+    QElapsedTimer timer;
+    timer.start();
+    quint64 repliesReceived = m_repliesReceived;
+
+    while (!reply->first && m_process.state() == QProcess::Running) {
+        if (repliesReceived != m_repliesReceived) {
+            repliesReceived = m_repliesReceived;
+            timer.restart();
+        }
+
+        const qint64 remaining = synchronousTimeout - timer.elapsed();
+        if (remaining <= 0) {
+            qCWarning(daemon, "DeviceLock: Lock code plugin worker didn't reply to %s within %d ms, restarting it",
+                        qPrintable(arguments.value(0)), synchronousTimeout);
+
+            m_process.kill();
+            m_process.waitForFinished(1000);
+            break;
+        }
+        m_process.waitForReadyRead(int(remaining));
+    }
+
+    --m_synchronousCalls;
+
+    if (m_synchronousCalls == 0 && !m_deferredReplies.isEmpty()) {
+        QTimer::singleShot(0, this, &PluginWorker::deliverDeferredReplies);
+    }
+
+    // The request was sent and may have been acted on even without a reply, it isn't safe to
+    // repeat it.
+    *result = reply->first ? reply->second : int(HostAuthenticationInput::Failure);
+    return true;
+}
+
+void PluginWorker::call(
+        const QStringList &arguments, QObject *context, const std::function<void(int result)> &callback)
+{
+    m_requests.enqueue({ context, callback, false });
+
+    sendRequest(arguments);
+}
+
+void PluginWorker::sendRequest(const QStringList &arguments)
+{
+    QByteArray request = encodeRequest(arguments);
+    m_process.write(request);
+    request.fill('\0');
+}
+
+void PluginWorker::readReplies()
+{
+    m_buffer.append(m_process.readAllStandardOutput());
+
+    while (m_buffer.size() >= int(sizeof(qint32)) && !m_requests.isEmpty()) {
+        const qint32 exitCode = qFromBigEndian<qint32>(reinterpret_cast<const uchar *>(m_buffer.constData()));
+        m_buffer.remove(0, sizeof(qint32));
+        ++m_repliesReceived;
+
+        // Dequeue before invoking the callback, it may issue requests of its own.
+        deliver(m_requests.dequeue(), -exitCode);
+    }
+}
+
+void PluginWorker::deliver(const Request &request, int result)
+{
+    if (!request.context) {
+        return;
+    } else if (!request.synchronous && (m_synchronousCalls > 0 || !m_deferredReplies.isEmpty())) {
+        // Don't change the state of the caller of a synchronous call underneath it, and keep
+        // later replies behind those already held back so the order is preserved.
+        m_deferredReplies.append(qMakePair(request, result));
+    } else {
+        request.callback(result);
+    }
+}
+
+void PluginWorker::deliverDeferredReplies()
+{
+    while (m_synchronousCalls == 0 && !m_deferredReplies.isEmpty()) {
+        const QPair<Request, int> reply = m_deferredReplies.takeFirst();
+        if (reply.first.context) {
+            reply.first.callback(reply.second);
+        }
+    }
+}
+
+void PluginWorker::processFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (exitStatus == QProcess::CrashExit) {
+        qCWarning(daemon, "DeviceLock: Lock code plugin worker crashed, it will be restarted on the next request");
+    } else {
+        qCWarning(daemon, "DeviceLock: Lock code plugin worker exited with code %i, it will be restarted on the next request",
+                    exitCode);
+    }
+
+    m_buffer.clear();
+
+    // The requests that were in flight aren't retried as they may have already been acted on.
+    const QQueue<Request> requests = m_requests;
+    m_requests.clear();
+
+    for (const Request &request : requests) {
+        // A synchronous caller sees the worker has exited and fails its own request.
+        if (!request.synchronous) {
+            deliver(request, HostAuthenticationInput::Failure);
+        }
+    }
+}
+
+QByteArray PluginWorker::encodeRequest(const QStringList &arguments)
+{
+    QByteArray request;
+    {
+        QDataStream stream(&request, QIODevice::WriteOnly);
+        stream.setByteOrder(QDataStream::BigEndian);
+
+        stream << quint32(arguments.count());
+        for (const QString &argument : arguments) {
+            const QByteArray utf8 = argument.toUtf8();
+
+            stream << quint32(utf8.size());
+            stream.writeRawData(utf8.constData(), utf8.size());
+        }
+    }
+    return request;
+}
+
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef NEMODEVICELOCK_PLUGINWORKER_H
+#define NEMODEVICELOCK_PLUGINWORKER_H
+
+#include <QByteArray>
+#include <QPointer>
+#include <QProcess>
+#include <QQueue>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+namespace NemoDeviceLock
+{
+
+/*
+    A long lived instance of the lock code plugin.
+
+    The plugin is started once with the --worker argument and then receives requests over its
+    standard input instead of being started anew for every operation.  A request is the argument
+    list of the equivalent one-shot invocation encoded as a big endian 32 bit argument count
+    followed by each argument as a big endian 32 bit byte length and its UTF-8 encoded bytes.
+    The plugin replies to each request in order with a big endian 32 bit integer holding the exit
+    code the one-shot invocation would have returned.
+
+    Requests may be pipelined, replies are matched to requests in the order they were sent.
+    Replies to asynchronous requests which arrive while a synchronous call is waiting are held
+    back and delivered from the event loop once the call has returned.
+
+    A synchronous call returns false only if the worker couldn't be started and the request was
+    never sent.  A request which was sent is never repeated as the plugin may already have acted
+    on it, if the worker exits or doesn't reply in time the request fails instead.
+*/
+class PluginWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PluginWorker(const QString &program, QObject *parent = nullptr);
+    ~PluginWorker();
+
+    bool start();
+
+    bool call(const QStringList &arguments, int *result);
+    void call(const QStringList &arguments, QObject *context, const std::function<void(int result)> &callback);
+
+private slots:
+    void readReplies();
+    void deliverDeferredReplies();
+    void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    struct Request
+    {
+        QPointer<QObject> context;
+        std::function<void(int result)> callback;
+        bool synchronous;
+    };
+
+    void deliver(const Request &request, int result);
+
+    void sendRequest(const QStringList &arguments);
+
+    static QByteArray encodeRequest(const QStringList &arguments);
+
+    QProcess m_process;
+    QByteArray m_buffer;
+    QQueue<Request> m_requests;
+    QVector<QPair<Request, int>> m_deferredReplies;
+    const QString m_program;
+    int m_startFailures;
+    int m_synchronousCalls;
+    quint64 m_repliesReceived;
+};
+
+}
+
+#endif
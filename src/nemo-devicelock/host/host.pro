@@ -21,9 +21,11 @@ INCLUDEPATH += \
 LIBS += -L$$OUT_PWD/.. -lnemodevicelock
 
 PUBLIC_HEADERS += \
+        $$PWD/admissionlimiter.h \
         $$PWD/hostauthenticationinput.h \
         $$PWD/hostauthenticator.h \
         $$PWD/hostauthorization.h \
+        $$PWD/hostconnections.h \
         $$PWD/hostdevicelock.h \
         $$PWD/hostdevicelocksettings.h \
         $$PWD/hostdevicereset.h \
@@ -35,9 +37,11 @@ PUBLIC_HEADERS += \
         $$PWD/mcedevicelock.h
 
 SOURCES += \
+        $$PWD/admissionlimiter.cpp \
         $$PWD/hostauthenticationinput.cpp \
         $$PWD/hostauthenticator.cpp \
         $$PWD/hostauthorization.cpp \
+        $$PWD/hostconnections.cpp \
         $$PWD/hostdevicelock.cpp \
         $$PWD/hostdevicelocksettings.cpp \
         $$PWD/hostdevicereset.cpp \
@@ -46,12 +50,18 @@ SOURCES += \
         $$PWD/hostfingerprintsettings.cpp \
         $$PWD/hostobject.cpp \
         $$PWD/hostservice.cpp \
-        $$PWD/mcedevicelock.cpp
+        $$PWD/mcedevicelock.cpp \
+        $$PWD/randompool.cpp \
+        $$PWD/securitycodefilter.cpp \
+        $$PWD/verificationexecutor.cpp
 
 include (cli/cli.pri)
 
 HEADERS += \
-        $$PUBLIC_HEADERS
+        $$PUBLIC_HEADERS \
+        $$PWD/randompool.h \
+        $$PWD/securitycodefilter.h \
+        $$PWD/verificationexecutor.h
 
 headers.files = $$PUBLIC_HEADERS
 headers.path = /usr/include/nemo-devicelock/host
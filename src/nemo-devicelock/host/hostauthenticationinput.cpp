@@ -32,9 +32,10 @@
 
 #include "hostauthenticationinput.h"
 
+#include "randompool.h"
+#include "securitycodefilter.h"
 #include "settingswatcher.h"
-
-#include <QFile>
+#include "verificationexecutor.h"
 
 namespace NemoDeviceLock
 {
@@ -48,6 +49,11 @@ HostAuthenticationInputAdaptor::HostAuthenticationInputAdaptor(
 {
 }
 
+int HostAuthenticationInputAdaptor::currentAttempts() const
+{
+    return m_authenticationInput->currentAttempts();
+}
+
 void HostAuthenticationInputAdaptor::SetRegistered(const QDBusObjectPath &path, bool registered)
 {
     m_authenticationInput->setRegistered(path.path(), registered);
@@ -82,11 +88,16 @@ HostAuthenticationInput::HostAuthenticationInput(
         const QString &path, Authenticator::Methods supportedMethods, QObject *parent)
     : HostObject(path, parent)
     , m_adaptor(this)
-    , m_settings(SettingsWatcher::instance())
+    , m_settings(SettingsWatcher::instance(SettingsWatcher::Publisher))
+    , m_codeFilter(SecurityCodeFilter::instance())
+    , m_randomPool(RandomPool::instance())
+    , m_verificationExecutor(VerificationExecutor::instance())
     , m_supportedMethods(supportedMethods | Authenticator::Confirmation) // Basic yes/no confirmation is always supported.
     , m_activeMethods()
     , m_authenticating(false)
 {
+    connect(m_settings.data(), &SettingsWatcher::currentAttemptsChanged,
+            this, &HostAuthenticationInput::currentAttemptsChanged);
 }
 
 HostAuthenticationInput::~HostAuthenticationInput()
@@ -115,7 +126,7 @@ void HostAuthenticationInput::startAuthentication(
         const QVariantMap &data,
         Authenticator::Methods methods)
 {
-    const uint pid = connectionPid(QDBusContext::connection());
+    const uint pid = connectionPid(HostObject::connection());
     if (pid != 0) {
         startAuthentication(feedback, pid, data, methods);
     }
@@ -146,7 +157,7 @@ void HostAuthenticationInput::startAuthentication(
 
 void HostAuthenticationInput::authenticationUnavailable(AuthenticationInput::Error error)
 {
-    const uint pid = connectionPid(QDBusContext::connection());
+    const uint pid = connectionPid(HostObject::connection());
     if (pid != 0) {
         authenticationUnavailable(error, pid);
     }
@@ -238,14 +249,14 @@ void HostAuthenticationInput::authenticationEnded(bool confirmed)
 
 void HostAuthenticationInput::setRegistered(const QString &path, bool registered)
 {
-    const auto pid = connectionPid(QDBusContext::connection());
+    const auto pid = connectionPid(HostObject::connection());
 
     if (pid == 0 || !authorizeInput(pid)) {
-        QDBusContext::sendErrorReply(QDBusError::AccessDenied);
+        HostObject::sendErrorReply(QDBusError::AccessDenied);
         return;
     }
 
-    const auto connection = QDBusContext::connection().name();
+    const auto connection = HostObject::connection().name();
 
     if (registered) {
         for (int i = 0; i < m_inputStack.count(); ++i) {
@@ -284,7 +295,7 @@ void HostAuthenticationInput::setRegistered(const QString &path, bool registered
 
 void HostAuthenticationInput::setActive(const QString &path, bool active)
 {
-    const auto connection = QDBusContext::connection().name();
+    const auto connection = HostObject::connection().name();
 
     if (m_authenticating
             && !m_inputStack.isEmpty()
@@ -321,6 +332,19 @@ int HostAuthenticationInput::currentAttempts() const
     return m_settings->currentAttempts;
 }
 
+void HostAuthenticationInput::setCurrentAttempts(int attempts)
+{
+    m_settings->setCurrentAttempts(attempts);
+}
+
+void HostAuthenticationInput::currentAttemptsChanged()
+{
+    propertyChanged(
+                QStringLiteral("org.nemomobile.devicelock.AuthenticationInput"),
+                QStringLiteral("CurrentAttempts"),
+                currentAttempts());
+}
+
 qint64 HostAuthenticationInput::temporaryLockTimeout() const
 {
     return m_settings->temporaryLockTimeout;
@@ -336,6 +360,11 @@ int HostAuthenticationInput::maximumCodeLength() const
     return m_settings->maximumLength;
 }
 
+bool HostAuthenticationInput::isWeakSecurityCode(const QString &code) const
+{
+    return m_codeFilter->isWeak(code);
+}
+
 AuthenticationInput::CodeGeneration HostAuthenticationInput::codeGeneration() const
 {
     return m_settings->codeGeneration;
@@ -343,13 +372,20 @@ AuthenticationInput::CodeGeneration HostAuthenticationInput::codeGeneration() co
 
 QString HostAuthenticationInput::generateCode() const
 {
-    quint64 number = 0;
-    QFile file(QStringLiteral("/dev/random"));
-    if (file.open(QIODevice::ReadOnly)) {
-        file.read(reinterpret_cast<char *>(&number), sizeof(number));
-        file.close();
+    // Bytes beyond the largest multiple of ten would favor the lower digits, discard them instead.
+    const int limit = 250;
+
+    QString code;
+    code.reserve(m_settings->minimumLength);
+    while (code.length() < m_settings->minimumLength) {
+        quint8 byte;
+        if (!m_randomPool->next(&byte)) {
+            return QString();
+        } else if (byte < limit) {
+            code.append(QLatin1Char('0' + byte % 10));
+        }
     }
-    return QString::number(number).right(m_settings->minimumLength).rightJustified(m_settings->minimumLength, QLatin1Char('0'));
+    return code;
 }
 
 void HostAuthenticationInput::feedback(
@@ -384,6 +420,24 @@ void HostAuthenticationInput::feedback(
     HostAuthenticationInput::feedback(feedback, data, utilizedMethods);
 }
 
+int HostAuthenticationInput::startVerification(
+        const std::function<int()> &verification, const std::function<void(int result)> &finished)
+{
+    cancelVerification();
+
+    m_verification = m_verificationExecutor->start(verification, this, finished);
+
+    return Evaluating;
+}
+
+void HostAuthenticationInput::cancelVerification()
+{
+    if (m_verification) {
+        m_verification->cancel();
+        m_verification.clear();
+    }
+}
+
 void HostAuthenticationInput::lockedOut()
 {
     QVariantMap data;
@@ -456,7 +510,7 @@ void HostAuthenticationInput::clientDisconnected(const QString &connection)
 
 void HostAuthenticationInput::handleEnterSecurityCode(const QString &path, const QString &code)
 {
-    const auto connection = QDBusContext::connection().name();
+    const auto connection = HostObject::connection().name();
     if (!m_inputStack.isEmpty()
             && m_inputStack.last().connection == connection
             && m_inputStack.last().path == path) {
@@ -466,7 +520,7 @@ void HostAuthenticationInput::handleEnterSecurityCode(const QString &path, const
 
 void HostAuthenticationInput::handleRequestSecurityCode(const QString &path)
 {
-    const auto connection = QDBusContext::connection().name();
+    const auto connection = HostObject::connection().name();
     if (!m_inputStack.isEmpty()
             && m_inputStack.last().connection == connection
             && m_inputStack.last().path == path) {
@@ -476,7 +530,7 @@ void HostAuthenticationInput::handleRequestSecurityCode(const QString &path)
 
 void HostAuthenticationInput::handleCancel(const QString &path)
 {
-    const auto connection = QDBusContext::connection().name();
+    const auto connection = HostObject::connection().name();
     if (!m_inputStack.isEmpty()
             && m_inputStack.last().connection == connection
             && m_inputStack.last().path == path) {
@@ -486,7 +540,7 @@ void HostAuthenticationInput::handleCancel(const QString &path)
 
 void HostAuthenticationInput::handleAuthorize(const QString &path)
 {
-    const auto connection = QDBusContext::connection().name();
+    const auto connection = HostObject::connection().name();
     if (!m_inputStack.isEmpty()
             && m_inputStack.last().connection == connection
             && m_inputStack.last().path == path) {
@@ -36,6 +36,10 @@
 #include <nemo-devicelock/authenticationinput.h>
 #include <nemo-devicelock/host/hostobject.h>
 
+#include <QPointer>
+
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 class QDBusConnection;
 QT_END_NAMESPACE
@@ -44,13 +48,20 @@ namespace NemoDeviceLock
 {
 
 class HostAuthenticationInput;
+class RandomPool;
+class SecurityCodeFilter;
+class VerificationExecutor;
+class VerificationTask;
 class HostAuthenticationInputAdaptor : public QDBusAbstractAdaptor
 {
     Q_OBJECT
+    Q_PROPERTY(int CurrentAttempts READ currentAttempts)
     Q_CLASSINFO("D-Bus Interface", "org.nemomobile.devicelock.AuthenticationInput")
 public:
     explicit HostAuthenticationInputAdaptor(HostAuthenticationInput *authenticationInput);
 
+    int currentAttempts() const;
+
 public slots:
     void SetRegistered(const QDBusObjectPath &path, bool registered);
     void SetActive(const QDBusObjectPath &path, bool active);
@@ -110,6 +121,8 @@ public:
     virtual int minimumCodeLength() const;
     virtual int maximumCodeLength() const;
 
+    virtual bool isWeakSecurityCode(const QString &code) const;
+
     virtual AuthenticationInput::CodeGeneration codeGeneration() const;
     virtual QString generateCode() const;
 
@@ -165,6 +178,12 @@ public:
     void clientDisconnected(const QString &connectionName) override;
 
 protected:
+    void setCurrentAttempts(int attempts);
+
+    int startVerification(
+            const std::function<int()> &verification, const std::function<void(int result)> &finished);
+    void cancelVerification();
+
     void lockedOut();
     void lockedOut(
             Availability availability,
@@ -190,10 +209,15 @@ private:
 
     inline void setRegistered(const QString &path, bool registered);
     inline void setActive(const QString &path, bool active);
+    inline void currentAttemptsChanged();
 
     HostAuthenticationInputAdaptor m_adaptor;
     QExplicitlySharedDataPointer<SettingsWatcher> m_settings;
+    QExplicitlySharedDataPointer<SecurityCodeFilter> m_codeFilter;
+    QExplicitlySharedDataPointer<RandomPool> m_randomPool;
+    QExplicitlySharedDataPointer<VerificationExecutor> m_verificationExecutor;
     QVector<Input> m_inputStack;
+    QPointer<VerificationTask> m_verification;
     Authenticator::Methods m_supportedMethods;
     Authenticator::Methods m_activeMethods;
     bool m_authenticating;
@@ -141,7 +141,7 @@ bool HostAuthenticator::isSecurityCodeSet() const
 void HostAuthenticator::authenticate(
         const QString &client, const QVariant &challengeCode, Authenticator::Methods methods)
 {
-    const auto pid = connectionPid(QDBusContext::connection());
+    const auto pid = connectionPid(HostObject::connection());
 
     cancelPending();
 
@@ -149,9 +149,9 @@ void HostAuthenticator::authenticate(
         setActiveClient(client);
         beginAuthenticate(pid, challengeCode, methods);
     } else {
-        m_pending.connection = QDBusContext::connection().name();
+        m_pending.connection = HostObject::connection().name();
         m_pending.client = client;
-        m_pending.address = QDBusContext::message().service();
+        m_pending.address = HostObject::message().service();
         m_pending.pid = pid;
         m_pending.request = AuthenticateRequest;
         m_pending.challengeCode = challengeCode;
@@ -178,7 +178,7 @@ void HostAuthenticator::beginAuthenticate(
             authenticated(authenticateChallengeCode(
                               challengeCode,
                               Authenticator::NoAuthentication,
-                              connectionPid(QDBusContext::connection())));
+                              connectionPid(HostObject::connection())));
         }
         break;
     case CanAuthenticateSecurityCode:
@@ -213,7 +213,7 @@ void HostAuthenticator::requestPermission(
         const QVariantMap &properties,
         Authenticator::Methods methods)
 {
-    const auto pid = connectionPid(QDBusContext::connection());
+    const auto pid = connectionPid(HostObject::connection());
 
     cancelPending();
 
@@ -221,7 +221,7 @@ void HostAuthenticator::requestPermission(
         setActiveClient(client);
         beginRequestPermission(pid, message, properties, methods);
     } else {
-        m_pending.connection = QDBusContext::connection().name();
+        m_pending.connection = HostObject::connection().name();
         m_pending.client = client;
         m_pending.pid = pid;
         m_pending.request = PermissionRequest;
@@ -275,9 +275,9 @@ void HostAuthenticator::beginRequestPermission(
 
 void HostAuthenticator::handleChangeSecurityCode(const QString &client, const QVariant &challengeCode)
 {
-    const auto pid = connectionPid(QDBusContext::connection());
+    const auto pid = connectionPid(HostObject::connection());
     if (pid == 0 || !authorizeSecurityCodeSettings(pid)) {
-        QDBusContext::sendErrorReply(QDBusError::AccessDenied);
+        HostObject::sendErrorReply(QDBusError::AccessDenied);
         return;
     }
 
@@ -287,7 +287,7 @@ void HostAuthenticator::handleChangeSecurityCode(const QString &client, const QV
         setActiveClient(client);
         beginChangeSecurityCode(pid, challengeCode);
     } else {
-        m_pending.connection = QDBusContext::connection().name();
+        m_pending.connection = HostObject::connection().name();
         m_pending.client = client;
         m_pending.pid = pid;
         m_pending.request = ChangeRequest;
@@ -333,9 +333,9 @@ void HostAuthenticator::beginChangeSecurityCode(uint pid, const QVariant &challe
 
 void HostAuthenticator::handleClearSecurityCode(const QString &client)
 {
-    const auto pid = connectionPid(QDBusContext::connection());
+    const auto pid = connectionPid(HostObject::connection());
     if (pid == 0 || !authorizeSecurityCodeSettings(pid)) {
-        QDBusContext::sendErrorReply(QDBusError::AccessDenied);
+        HostObject::sendErrorReply(QDBusError::AccessDenied);
         return;
     }
 
@@ -345,7 +345,7 @@ void HostAuthenticator::handleClearSecurityCode(const QString &client)
         setActiveClient(client);
         beginClearSecurityCode(pid);
     } else {
-        m_pending.connection = QDBusContext::connection().name();
+        m_pending.connection = HostObject::connection().name();
         m_pending.client = client;
         m_pending.pid = pid;
         m_pending.request = ClearRequest;
@@ -360,7 +360,7 @@ void HostAuthenticator::beginClearSecurityCode(uint pid)
     switch (availability()) {
     case AuthenticationNotRequired:
         m_state = Idle;
-        QDBusContext::sendErrorReply(QDBusError::InvalidArgs);
+        HostObject::sendErrorReply(QDBusError::InvalidArgs);
         break;
     case CanAuthenticateSecurityCode:
     case CanAuthenticate:
@@ -412,6 +412,8 @@ void HostAuthenticator::enterSecurityCode(const QString &code)
             feedback(AuthenticationInput::NewSecurityCodeTooShort, -1);
         } else if (code.length() > maximumCodeLength()) {
             feedback(AuthenticationInput::NewSecurityCodeTooLong, -1);
+        } else if (isWeakSecurityCode(code)) {
+            feedback(AuthenticationInput::SecurityCodeTooWeak, -1);
         } else {
             m_newCode = code;
             m_state = RepeatingNewSecurityCode;
@@ -420,7 +422,7 @@ void HostAuthenticator::enterSecurityCode(const QString &code)
         }
         return;
     case ExpectingGeneratedSecurityCode:
-        if (m_generatedCode == code) {
+        if (!m_generatedCode.isEmpty() && m_generatedCode == code) {
             m_newCode = code;
             m_state = RepeatingNewSecurityCode;
             m_repeatsRequired = 2;
@@ -513,6 +515,10 @@ void HostAuthenticator::checkCodeFinished(int result)
 
     m_state = State(m_state & ~EvaluatingFlag);
 
+    if (result == Success || result == SecurityCodeExpired) {
+        setCurrentAttempts(0);
+    }
+
     switch (m_state) {
     case Authenticating:
     case RequestingPermission:
@@ -590,6 +596,10 @@ void HostAuthenticator::checkCodeFinished(int result)
     const int attempts = result;
     const int maximum = maximumAttempts();
 
+    if (attempts > 0) {
+        setCurrentAttempts(attempts);
+    }
+
     QVariantMap data;
     if (maximum > 0 && attempts > 0) {
         data.insert(attemptsRemaining, qMax(0, maximum - attempts));
@@ -749,18 +759,23 @@ void HostAuthenticator::cancel()
     case Changing:
         m_state = ChangeCanceled;
         return;
+    // We're waiting for a security code to be verified. If the verification was offloaded to a
+    // worker it is canceled, otherwise the result is handled according to the canceled state.
     case AuthenticationEvaluating:
     case PermissionEvaluating:
         m_state = AuthenticationCanceled;
         authenticationInactive();
+        cancelVerification();
         return;
     case AuthenticationForChangeEvaluating:
-        m_state = AuthenticationForClearCanceled;
+        m_state = AuthenticationForChangeCanceled;
         authenticationInactive();
+        cancelVerification();
         return;
     case AuthenticationForClearEvaluating:
-        m_state = AuthenticationForChangeCanceled;
+        m_state = AuthenticationForClearCanceled;
         authenticationInactive();
+        cancelVerification();
         return;
     // Something has already tried to interrupt a time consuming and uninterruptable operation.
     case ChangeCanceled:
@@ -827,8 +842,8 @@ void HostAuthenticator::availabilityChanged()
 
 void HostAuthenticator::handleCancel(const QString &client)
 {
-    const QString connection = QDBusContext::connection().name();
-    const QString address = QDBusContext::message().service();
+    const QString connection = HostObject::connection().name();
+    const QString address = HostObject::message().service();
 
     if (m_pending.request != NoRequest) {
         if (m_pending.connection == connection && m_pending.address == address && m_pending.client == client) {
@@ -72,19 +72,19 @@ void HostAuthorization::requestChallenge(const QString &, Authenticator::Methods
 {
     const auto methods = m_allowedMethods & requestedMethods;
     if (methods) {
-        QDBusContext::setDelayedReply(true);
+        HostObject::setDelayedReply(true);
 
-        QDBusContext::connection().send(QDBusContext::message().createReply(NemoDBus::marshallArguments(
+        HostObject::connection().send(HostObject::message().createReply(NemoDBus::marshallArguments(
                     QVariant(0), uint(methods))));
     } else {
-        QDBusContext::sendErrorReply(QDBusError::NotSupported);
+        HostObject::sendErrorReply(QDBusError::NotSupported);
     }
 }
 
 void HostAuthorization::relinquishChallenge(const QString &)
 {
     if (!m_allowedMethods) {
-        QDBusContext::sendErrorReply(QDBusError::NotSupported);
+        HostObject::sendErrorReply(QDBusError::NotSupported);
     }
 }
 
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "hostconnections.h"
+
+#include "hostobject.h"
+
+#include "objectdispatcher.h"
+
+#include <dbus/dbus.h>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace NemoDeviceLock
+{
+
+static const int maximumDeferredMessages = 32;
+
+HostConnections *HostConnections::sharedInstance = nullptr;
+
+bool HostConnections::Peer::isAlive() const
+{
+    if (pidfd < 0) {
+        return pid != 0;
+    }
+
+    // A pidfd becomes readable when the process exits.
+    struct pollfd descriptor = { pidfd, POLLIN, 0 };
+    return poll(&descriptor, 1, 0) == 0;
+}
+
+HostConnections::HostConnections(const QVector<HostObject *> &objects, QObject *parent)
+    : QDBusVirtualObject(parent)
+    , m_objects(objects)
+    , m_nextId(0)
+{
+    Q_ASSERT(!sharedInstance);
+    sharedInstance = this;
+
+    for (int i = 0; i < m_objects.count(); ++i) {
+        m_paths.insert(m_objects.at(i)->path(), i);
+    }
+}
+
+HostConnections::~HostConnections()
+{
+    for (const Peer &peer : m_peers) {
+        if (peer.pidfd >= 0) {
+            close(peer.pidfd);
+        }
+    }
+
+    sharedInstance = nullptr;
+}
+
+static int openPidfd(int socket, pid_t pid)
+{
+    int pidfd = -1;
+#if defined(SO_PEERPIDFD)
+    socklen_t length = sizeof(pidfd);
+    if (getsockopt(socket, SOL_SOCKET, SO_PEERPIDFD, &pidfd, &length) == 0) {
+        return pidfd;
+    }
+#else
+    Q_UNUSED(socket);
+#endif
+#if defined(SYS_pidfd_open)
+    pidfd = syscall(SYS_pidfd_open, pid, 0);
+#else
+    Q_UNUSED(pid);
+#endif
+    return pidfd;
+}
+
+HostConnections::Peer *HostConnections::insert(const QDBusConnection &connection)
+{
+    Peer peer(connection, ++m_nextId);
+
+    // libdbus may not have authenticated the connection yet but the kernel knows the
+    // credentials of the connecting process.
+    int socket = -1;
+    struct ucred credentials;
+    socklen_t length = sizeof(credentials);
+    if (dbus_connection_get_socket(static_cast<DBusConnection *>(connection.internalPointer()), &socket)
+            && getsockopt(socket, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0) {
+        peer.pid = credentials.pid;
+        peer.uid = credentials.uid;
+        peer.gid = credentials.gid;
+        peer.pidfd = openPidfd(socket, credentials.pid);
+    } else {
+        qCWarning(daemon, "Failed to get the credentials of connection %s", qPrintable(connection.name()));
+    }
+
+    return &*m_peers.insert(connection.name(), peer);
+}
+
+HostConnections::Peer *HostConnections::find(const QString &name)
+{
+    const auto it = m_peers.find(name);
+
+    return it != m_peers.end() ? &*it : nullptr;
+}
+
+HostConnections::Peer HostConnections::take(const QString &name)
+{
+    Peer peer = m_peers.take(name);
+
+    if (peer.pidfd >= 0) {
+        close(peer.pidfd);
+        peer.pidfd = -1;
+    }
+
+    return peer;
+}
+
+int HostConnections::count() const
+{
+    return m_peers.count();
+}
+
+const HostConnections::Peer *HostConnections::peer(const QDBusConnection &connection)
+{
+    return sharedInstance ? sharedInstance->find(connection.name()) : nullptr;
+}
+
+int HostConnections::objectIndex(const QString &path) const
+{
+    return m_paths.value(path, -1);
+}
+
+bool HostConnections::handleMessage(const QDBusMessage &message, const QDBusConnection &connection)
+{
+    const int index = objectIndex(message.path());
+    const auto it = m_peers.find(connection.name());
+
+    if (it != m_peers.end() && !it->admitted) {
+        const int deferred = it->deferredMessages.count();
+        if (deferred < maximumDeferredMessages) {
+            it->deferredMessages.append(message);
+        } else if (deferred == maximumDeferredMessages) {
+            qCWarning(daemon, "Too many calls on deferred connection %s, dropping it", qPrintable(connection.name()));
+
+            // Nothing more is held once the limit is exceeded, the placeholder only ensures the
+            // connection is dropped once.
+            it->deferredMessages.append(QDBusMessage());
+
+            emit deferralExceeded(connection.name());
+        }
+        return true;
+    }
+
+    if (index == -1 || it == m_peers.end() || !(it->objects & (1u << index))) {
+        return false;
+    }
+
+    return m_objects.at(index)->dispatch(message, connection);
+}
+
+QString HostConnections::introspect(const QString &path) const
+{
+    const int index = objectIndex(path);
+
+    return index != -1 ? introspectAdaptors(m_objects.at(index)) : QString();
+}
+
+}
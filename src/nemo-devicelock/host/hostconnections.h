@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef NEMODEVICELOCK_HOSTCONNECTIONS_H
+#define NEMODEVICELOCK_HOSTCONNECTIONS_H
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusVirtualObject>
+#include <QHash>
+#include <QVector>
+
+#include <sys/types.h>
+
+namespace NemoDeviceLock
+{
+
+class HostObject;
+
+/*
+    The peer connections of the daemon and the host objects registered on each.  Every host
+    object is assigned a bit in the objects mask of a connection so objects can find the
+    connections they should broadcast to without keeping their own lists.
+
+    It is also the single virtual object registered on every connection, calls are routed to
+    the host object with the called path if that object is registered on the connection.
+*/
+class HostConnections : public QDBusVirtualObject
+{
+    Q_OBJECT
+public:
+    struct Peer
+    {
+        Peer() : connection(QString()), id(0), objects(0), pid(0), uid(-1), gid(-1), pidfd(-1), admitted(true) {}
+        Peer(const QDBusConnection &connection, quint32 id)
+            : connection(connection), id(id), objects(0), pid(0), uid(-1), gid(-1), pidfd(-1), admitted(true) {}
+
+        bool isAlive() const;
+
+        QDBusConnection connection;
+        quint32 id;
+        quint32 objects;
+
+        // The credentials of the connecting process, captured when the connection is accepted.
+        // The pidfd refers to that process even if its PID is later reused.
+        pid_t pid;
+        uid_t uid;
+        gid_t gid;
+        int pidfd;
+
+        // Calls made on a connection which hasn't been admitted yet are held until it is, up to a
+        // limit after which the connection is dropped.
+        QVector<QDBusMessage> deferredMessages;
+        bool admitted;
+    };
+
+    explicit HostConnections(const QVector<HostObject *> &objects, QObject *parent = nullptr);
+    ~HostConnections();
+
+    Peer *insert(const QDBusConnection &connection);
+    Peer *find(const QString &name);
+    Peer take(const QString &name);
+
+    int count() const;
+
+    static const Peer *peer(const QDBusConnection &connection);
+
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override;
+    QString introspect(const QString &path) const override;
+
+    template <typename Function> void forEach(quint32 objects, const Function &function) const
+    {
+        for (const Peer &peer : m_peers) {
+            if (peer.objects & objects) {
+                function(peer);
+            }
+        }
+    }
+
+signals:
+    void deferralExceeded(const QString &connectionName);
+
+private:
+    int objectIndex(const QString &path) const;
+
+    QHash<QString, Peer> m_peers;
+    QHash<QString, int> m_paths;
+    const QVector<HostObject *> m_objects;
+    quint32 m_nextId;
+
+    static HostConnections *sharedInstance;
+};
+
+}
+
+#endif
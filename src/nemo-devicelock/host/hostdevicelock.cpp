@@ -71,7 +71,7 @@ void HostDeviceLockAdaptor::Cancel()
 HostDeviceLock::HostDeviceLock(Authenticator::Methods supportedMethods, QObject *parent)
     : HostAuthenticationInput(QStringLiteral("/devicelock/lock"), supportedMethods, parent)
     , m_adaptor(this)
-    , m_settings(SettingsWatcher::instance())
+    , m_settings(SettingsWatcher::instance(SettingsWatcher::Publisher))
     , m_repeatsRequired(0)
     , m_state(Idle)
     , m_lockState(DeviceLock::Undefined)
@@ -174,13 +174,17 @@ void HostDeviceLock::enterSecurityCode(const QString &code)
         break;
     }
     case EnteringNewSecurityCode:
+        if (isWeakSecurityCode(code)) {
+            feedback(AuthenticationInput::SecurityCodeTooWeak, -1);
+            break;
+        }
         m_newCode = code;
         m_state = RepeatingNewSecurityCode;
         m_repeatsRequired = 1;
         feedback(AuthenticationInput::RepeatNewSecurityCode, -1);
         break;
     case ExpectingGeneratedSecurityCode:
-        if (m_generatedCode == code) {
+        if (!m_generatedCode.isEmpty() && m_generatedCode == code) {
             m_newCode = code;
             m_state = RepeatingNewSecurityCode;
             m_repeatsRequired = 2;
@@ -209,6 +213,8 @@ void HostDeviceLock::enterSecurityCode(const QString &code)
             break;
         } else if (--m_repeatsRequired > 0) {
             feedback(AuthenticationInput::RepeatNewSecurityCode, -1);
+        } else if (canSetCodeAndUnlock()) {
+            setCodeAndUnlockFinished(setCodeAndUnlock(m_currentCode, code));
         } else {
             setCodeFinished(setCode(m_currentCode, code));
         }
@@ -233,12 +239,24 @@ void HostDeviceLock::requestSecurityCode()
 
 void HostDeviceLock::unlockFinished(int result, Authenticator::Method method)
 {
+    if (m_state == Canceled && result != Success) {
+        // The user canceled while the result was being evaluated, there's nothing to resume.
+        m_state = Idle;
+        m_currentCode.clear();
+
+        authenticationEnded(false);
+
+        unlockingChanged();
+        return;
+    }
+
     switch (result) {
     case Success:
+        setCurrentAttempts(0);
         confirmAuthentication(method);
         break;
     case Evaluating:
-        if (m_state == Authenticating) {
+        if (m_state == Authenticating || m_state == RepeatingNewSecurityCode) {
             m_state = Unlocking;
             authenticationEvaluating();
         } else if (m_state == ChangingSecurityCode) {
@@ -248,6 +266,7 @@ void HostDeviceLock::unlockFinished(int result, Authenticator::Method method)
         }
         break;
     case SecurityCodeExpired:
+        setCurrentAttempts(0);
         enterCodeChangeState(&HostAuthenticationInput::feedback);
         authenticationResumed(AuthenticationInput::SecurityCodeExpired, QVariantMap(), Authenticator::SecurityCode);
         break;
@@ -267,6 +286,10 @@ void HostDeviceLock::unlockFinished(int result, Authenticator::Method method)
         int attemptsRemaining = -1;
         const int maximum = maximumAttempts();
 
+        if (result > 0) {
+            setCurrentAttempts(result);
+        }
+
         if (maximum > 0) {
             if (result >= maximum) {
                 feedback(AuthenticationInput::IncorrectSecurityCode, 0);
@@ -338,9 +361,57 @@ void HostDeviceLock::setCodeFinished(int result)
     m_newCode.clear();
 }
 
+void HostDeviceLock::setCodeAndUnlockFinished(int result)
+{
+    switch (result) {
+    case Success:
+        qCDebug(daemon, "Security code changed.");
+        m_currentCode.clear();
+        m_newCode.clear();
+
+        if (m_state == Canceled) {
+            // The new code is kept but the device stays locked, as it would if the code had
+            // been changed without unlocking.
+            m_state = Idle;
+
+            authenticationEnded(false);
+
+            unlockingChanged();
+        } else {
+            unlockFinished(Success, Authenticator::SecurityCode);
+        }
+        break;
+    case Evaluating:
+        if (m_state == RepeatingNewSecurityCode) {
+            m_state = ChangingSecurityCode;
+            authenticationEvaluating();
+        } else {
+            abortAuthentication(AuthenticationInput::SoftwareError);
+        }
+        break;
+    default:
+        setCodeFinished(result);
+        break;
+    }
+}
+
+bool HostDeviceLock::canSetCodeAndUnlock() const
+{
+    return false;
+}
+
+int HostDeviceLock::setCodeAndUnlock(const QString &, const QString &)
+{
+    return Failure;
+}
+
 void HostDeviceLock::cancel()
 {
-    if (m_state == Unlocking || m_state == ChangingSecurityCode) {
+    if (m_state == Unlocking) {
+        m_state = Canceled;
+        cancelVerification();
+    } else if (m_state == ChangingSecurityCode) {
+        // Changing the code can't be safely interrupted, wait for it to complete.
         m_state = Canceled;
     } else if (m_state != Idle && m_state != Canceled) {
         m_state = Idle;
@@ -91,6 +91,9 @@ public:
 
     virtual int unlockWithCode(const QString &code) = 0;
 
+    virtual bool canSetCodeAndUnlock() const;
+    virtual int setCodeAndUnlock(const QString &oldCode, const QString &newCode);
+
     virtual bool isLocked() const = 0;
     virtual void setLocked(bool locked) = 0;
 
@@ -104,6 +107,7 @@ public:
 
     void unlockFinished(int result, Authenticator::Method method);
     void setCodeFinished(int result);
+    void setCodeAndUnlockFinished(int result);
 
     // Signals
     void notice(DeviceLock::Notice notice, const QVariantMap &data);
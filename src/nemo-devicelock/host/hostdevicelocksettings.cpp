@@ -50,6 +50,14 @@ void HostDeviceLockSettingsAdaptor::ChangeSetting(
     m_settings->changeSetting(path.path(), authenticationToken.variant(), key, value.variant());
 }
 
+void HostDeviceLockSettingsAdaptor::ChangeSettings(
+        const QDBusObjectPath &path,
+        const QDBusVariant &authenticationToken,
+        const QVariantMap &settings)
+{
+    m_settings->changeSettings(path.path(), authenticationToken.variant(), settings);
+}
+
 HostDeviceLockSettings::HostDeviceLockSettings(Authenticator::Methods allowedMethods, QObject *parent)
     : HostAuthorization(QStringLiteral("/devicelock/settings"), allowedMethods, parent)
     , m_adaptor(this)
@@ -60,4 +68,9 @@ HostDeviceLockSettings::~HostDeviceLockSettings()
 {
 }
 
+void HostDeviceLockSettings::changeSettings(const QString &, const QVariant &, const QVariantMap &)
+{
+    HostObject::sendErrorReply(QDBusError::NotSupported);
+}
+
 }
@@ -54,6 +54,10 @@ public slots:
             const QDBusVariant &authenticationToken,
             const QString &key,
             const QDBusVariant &value);
+    void ChangeSettings(
+            const QDBusObjectPath &path,
+            const QDBusVariant &authenticationToken,
+            const QVariantMap &settings);
 
 private:
     HostDeviceLockSettings * const m_settings;
@@ -72,6 +76,10 @@ protected:
             const QVariant &authenticationToken,
             const QString &key,
             const QVariant &value) = 0;
+    virtual void changeSettings(
+            const QString &requestor,
+            const QVariant &authenticationToken,
+            const QVariantMap &settings);
 
 private:
     friend class HostDeviceLockSettingsAdaptor;
@@ -64,7 +64,7 @@ HostDeviceReset::~HostDeviceReset()
 
 void HostDeviceReset::clearDevice(const QString &, const QVariant &, DeviceReset::Options)
 {
-    QDBusContext::sendErrorReply(QDBusError::NotSupported);
+    HostObject::sendErrorReply(QDBusError::NotSupported);
 }
 
 }
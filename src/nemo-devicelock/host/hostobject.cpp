@@ -32,6 +32,9 @@
 
 #include "hostobject.h"
 
+#include "hostconnections.h"
+#include "objectdispatcher.h"
+
 #include <QThreadStorage>
 
 #include <dbus/dbus.h>
@@ -61,6 +64,12 @@ NemoDBus::Connection systemBus()
 HostObject::HostObject(const QString &path, QObject *parent)
     : QObject(parent)
     , m_path(path)
+    , m_connections(nullptr)
+    , m_dispatchConnection(nullptr)
+    , m_dispatchMessage(nullptr)
+    , m_propertyChanges(0)
+    , m_propertySignals(0)
+    , m_connectionMask(0)
 {
 }
 
@@ -77,15 +86,74 @@ void HostObject::cancel()
 {
 }
 
+void HostObject::setConnections(HostConnections *connections, quint32 mask)
+{
+    m_connections = connections;
+    m_connectionMask = mask;
+}
+
+bool HostObject::dispatch(const QDBusMessage &message, const QDBusConnection &connection)
+{
+    const auto previousConnection = m_dispatchConnection;
+    const auto previousMessage = m_dispatchMessage;
+
+    m_dispatchConnection = &connection;
+    m_dispatchMessage = &message;
+
+    const bool dispatched = dispatchToAdaptor(this, message, connection);
+
+    m_dispatchConnection = previousConnection;
+    m_dispatchMessage = previousMessage;
+
+    return dispatched;
+}
+
+QDBusConnection HostObject::connection() const
+{
+    return m_dispatchConnection ? *m_dispatchConnection : QDBusContext::connection();
+}
+
+const QDBusMessage &HostObject::message() const
+{
+    return m_dispatchMessage ? *m_dispatchMessage : QDBusContext::message();
+}
+
+void HostObject::setDelayedReply(bool enable) const
+{
+    if (m_dispatchMessage) {
+        m_dispatchMessage->setDelayedReply(enable);
+    } else {
+        QDBusContext::setDelayedReply(enable);
+    }
+}
+
+void HostObject::sendErrorReply(const QString &name, const QString &message) const
+{
+    if (m_dispatchMessage) {
+        m_dispatchMessage->setDelayedReply(true);
+        m_dispatchConnection->send(m_dispatchMessage->createErrorReply(name, message));
+    } else {
+        QDBusContext::sendErrorReply(name, message);
+    }
+}
+
+void HostObject::sendErrorReply(QDBusError::ErrorType type, const QString &message) const
+{
+    if (m_dispatchMessage) {
+        m_dispatchMessage->setDelayedReply(true);
+        m_dispatchConnection->send(m_dispatchMessage->createErrorReply(type, message));
+    } else {
+        QDBusContext::sendErrorReply(type, message);
+    }
+}
+
 void HostObject::clientConnected(const QString &connectionName)
 {
-    m_connections.append(connectionName);
+    Q_UNUSED(connectionName);
 }
 
 void HostObject::clientDisconnected(const QString &connectionName)
 {
-    m_connections.removeOne(connectionName);
-
     if (m_activeConnection == connectionName) {
         m_activeConnection.clear();
         m_activeAddress.clear();
@@ -109,29 +177,78 @@ void HostObject::propertyChanged(const QString &interface, const QString &proper
     qCDebug(daemon, "DBus property changed (%s %s.%s): %s",
             qPrintable(m_path), qPrintable(interface), qPrintable(property), qPrintable(value.toString()));
 
-    const QVariantMap properties = { { property, value } };
+    // Changes made in the same event loop iteration are sent to clients in a single signal
+    // per interface.
+    if (m_pendingInterfaces.isEmpty()) {
+        QMetaObject::invokeMethod(this, "flushPropertyChanges", Qt::QueuedConnection);
+    }
+
+    if (!m_pendingInterfaces.contains(interface)) {
+        m_pendingInterfaces.append(interface);
+    }
+
+    m_pendingProperties[interface].insert(property, value);
+
+    ++m_propertyChanges;
+}
+
+void HostObject::flushPropertyChanges()
+{
+    if (m_pendingInterfaces.isEmpty()) {
+        return;
+    }
+
+    const QStringList interfaces = m_pendingInterfaces;
+    m_pendingInterfaces.clear();
+
+    QDBusMessage message = QDBusMessage::createSignal(
+                m_path, QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("PropertiesChanged"));
 
-    broadcastSignal(
-                QStringLiteral("org.freedesktop.DBus.Properties"),
-                QStringLiteral("PropertiesChanged"),
-                NemoDBus::marshallArguments(interface, properties, QStringList()));
+    for (const QString &interface : interfaces) {
+        message.setArguments(NemoDBus::marshallArguments(
+                    interface, m_pendingProperties.take(interface), QStringList()));
+
+        sendToClients(message);
+
+        ++m_propertySignals;
+    }
+
+    qCDebug(daemon, "Sent %d PropertiesChanged signals for %d property changes on %s",
+            m_propertySignals, m_propertyChanges, qPrintable(m_path));
 }
 
 void HostObject::broadcastSignal(const QString &interface, const QString &name, const QVariantList &arguments)
 {
+    // Clients expect properties to be up to date when they receive other signals.
+    flushPropertyChanges();
+
     QDBusMessage message = QDBusMessage::createSignal(m_path, interface, name);
 
     message.setArguments(arguments);
 
-    for (const auto connectionName : m_connections) {
-        QDBusConnection(connectionName).send(message);
+    sendToClients(message);
+}
+
+void HostObject::sendToClients(const QDBusMessage &message)
+{
+    if (!m_connections) {
+        return;
     }
+
+    // The message is built once and only serialized by each connection it's sent on.
+    m_connections->forEach(m_connectionMask, [&](const HostConnections::Peer &peer) {
+        peer.connection.send(message);
+    });
 }
 
 unsigned long HostObject::connectionPid(const QDBusConnection &connection)
 {
     unsigned long pid = 0;
-    if (dbus_connection_get_unix_process_id(
+    const auto peer = HostConnections::peer(connection);
+    if (peer && peer->pid != 0) {
+        // Don't attribute a call to a process which has since exited, its PID may be reused.
+        return peer->isAlive() ? peer->pid : 0;
+    } else if (dbus_connection_get_unix_process_id(
                 static_cast<DBusConnection *>(connection.internalPointer()), &pid)) {
         return pid;
     } else {
@@ -142,7 +259,10 @@ unsigned long HostObject::connectionPid(const QDBusConnection &connection)
 unsigned long HostObject::connectionUid(const QDBusConnection &connection)
 {
     unsigned long uid = -1;
-    if (dbus_connection_get_unix_user(
+    const auto peer = HostConnections::peer(connection);
+    if (peer && peer->pid != 0) {
+        return peer->uid;
+    } else if (dbus_connection_get_unix_user(
                 static_cast<DBusConnection *>(connection.internalPointer()), &uid)) {
         return uid;
     } else {
@@ -164,7 +284,7 @@ bool HostObject::isActiveClient(const QString &connection, const QString &addres
 
 bool HostObject::isActiveClient(const QString &client) const
 {
-    return isActiveClient(QDBusContext::connection().name(), QDBusContext::message().service(), client);
+    return isActiveClient(connection().name(), message().service(), client);
 }
 
 void HostObject::setActiveClient(const QString &connection, const QString &address, const QString &client)
@@ -176,7 +296,7 @@ void HostObject::setActiveClient(const QString &connection, const QString &addre
 
 void HostObject::setActiveClient(const QString &client)
 {
-    setActiveClient(QDBusContext::connection().name(), QDBusContext::message().service(), client);
+    setActiveClient(connection().name(), message().service(), client);
 }
 
 void HostObject::clearActiveClient()
@@ -34,6 +34,7 @@
 #define NEMODEVICELOCK_HOSTOBJECT_H
 
 #include <QDBusContext>
+#include <QHash>
 #include <QLoggingCategory>
 
 #include <nemo-dbus/connection.h>
@@ -45,6 +46,7 @@ Q_DECLARE_LOGGING_CATEGORY(daemon)
 
 NemoDBus::Connection systemBus();
 
+class HostConnections;
 class HostObject : public QObject, protected QDBusContext
 {
     Q_OBJECT
@@ -66,6 +68,10 @@ public:
 
     virtual bool authorizeConnection(const QDBusConnection &connection);
 
+    void setConnections(HostConnections *connections, quint32 mask);
+
+    bool dispatch(const QDBusMessage &message, const QDBusConnection &connection);
+
     bool isActiveClient(const QString &connection, const QString &address, const QString &client) const;
     bool isActiveClient(const QString &client) const;
     void setActiveClient(const QString &client);
@@ -73,6 +79,15 @@ public:
     void clearActiveClient();
 
 protected:
+    // Calls from peer connections are routed by HostConnections rather than by Qt so the context
+    // of those calls isn't available from QDBusContext.  These should be used instead, they
+    // fall back to QDBusContext for calls Qt dispatches directly.
+    QDBusConnection connection() const;
+    const QDBusMessage &message() const;
+    void setDelayedReply(bool enable) const;
+    void sendErrorReply(const QString &name, const QString &message = QString()) const;
+    void sendErrorReply(QDBusError::ErrorType type, const QString &message = QString()) const;
+
     void propertyChanged(const QString &interface, const QString &property, const QVariant &value);
     void broadcastSignal(const QString &interface, const QString &name, const QVariantList &arguments);
 
@@ -84,15 +99,28 @@ protected:
         if (!m_activeConnection.isEmpty()) {
             QDBusMessage message = QDBusMessage::createMethodCall(m_activeAddress, m_activeClient, interface, method);
             message.setArguments(NemoDBus::marshallArguments(arguments...));
+            flushPropertyChanges();
             return QDBusConnection(m_activeConnection).send(message);
         } else {
             return false;
         }
     }
 
+private slots:
+    void flushPropertyChanges();
+
 private:
+    void sendToClients(const QDBusMessage &message);
+
     const QString m_path;
-    QStringList m_connections;
+    HostConnections *m_connections;
+    const QDBusConnection *m_dispatchConnection;
+    const QDBusMessage *m_dispatchMessage;
+    QStringList m_pendingInterfaces;
+    QHash<QString, QVariantMap> m_pendingProperties;
+    int m_propertyChanges;
+    int m_propertySignals;
+    quint32 m_connectionMask;
     QString m_activeConnection;
     QString m_activeAddress;
     QString m_activeClient;
@@ -41,16 +41,20 @@
 #include "hostfingerprintsettings.h"
 
 #include <QDBusConnection>
+#include <QDBusError>
 #include <QDBusMetaType>
 #include <QDir>
-#include <QThread>
+#include <QtAlgorithms>
 
-#include <dbus/dbus.h>
 #include <systemd/sd-daemon.h>
 
 namespace NemoDeviceLock
 {
 
+// Connections per second, and the number which may be accepted at once.
+static const int admissionRate = 20;
+static const int admissionBurst = 10;
+
 class ConnectionMonitor : public QObject
 {
     Q_OBJECT
@@ -60,6 +64,7 @@ public:
         , m_service(service)
         , m_connectionName(connectionName)
     {
+        setObjectName(connectionName);
     }
 
 public slots:
@@ -67,8 +72,13 @@ public slots:
     {
         deleteLater();
 
-        for (const auto object : m_service->m_objects) {
-            object->clientDisconnected(m_connectionName);
+        m_service->m_deferredConnections.removeOne(m_connectionName);
+
+        // Only the objects registered on the connection need to know of its loss.
+        for (quint32 objects = m_service->m_connections.take(m_connectionName).objects;
+                objects != 0;
+                objects &= objects - 1) {
+            m_service->m_objects.at(qCountTrailingZeroBits(objects))->clientDisconnected(m_connectionName);
         }
 
         QDBusConnection::disconnectFromPeer(m_connectionName);
@@ -82,7 +92,23 @@ private:
 HostService::HostService(const QVector<HostObject *> objects, QObject *parent)
     : QDBusServer(HostService::socketAddress(), parent)
     , m_objects(objects)
+    , m_connections(objects)
+    , m_admissionLimiter(admissionRate, admissionBurst)
 {
+    Q_ASSERT(m_objects.count() <= 32);
+
+    for (int i = 0; i < m_objects.count(); ++i) {
+        m_objects.at(i)->setConnections(&m_connections, 1u << i);
+    }
+
+    m_admissionTimer.start();
+
+    m_deferralTimer.setSingleShot(true);
+    connect(&m_deferralTimer, &QTimer::timeout, this, &HostService::admitDeferredConnections);
+
+    connect(&m_connections, &HostConnections::deferralExceeded,
+            this, &HostService::dropConnection, Qt::QueuedConnection);
+
     setAnonymousAuthenticationAllowed(true);
 
     connect(this, &QDBusServer::newConnection, this, &HostService::connectionReady);
@@ -134,12 +160,8 @@ HostService::HostService(
 
 HostService::~HostService()
 {
-}
-
-static void registerObject(QDBusConnection &connection, const QString &path, QObject *object)
-{
-    if (!connection.registerObject(path, object)) {
-        qCWarning(daemon, "Failed to register object on path %s", qPrintable(path));
+    for (const auto object : m_objects) {
+        object->setConnections(nullptr, 0);
     }
 }
 
@@ -163,26 +185,105 @@ void HostService::connectionReady(const QDBusConnection &newConnection)
         qCWarning(daemon, "Failed to connect to disconnect signal");
     }
 
-    // The PID and UID of the connecting process can't be acquired until after the connection
-    // is authenticated which is done concurrently to the invokation of this slot.  Block until
-    // the connection is authenticated or disconnected before trying to decide which services
-    // a process should have access to.
-    auto internalConnection = static_cast<DBusConnection *>(connection.internalPointer());
-    while (dbus_connection_get_is_connected(internalConnection)
-           && !dbus_connection_get_is_authenticated(internalConnection)) {
-        QThread::usleep(100);
+    // The connection is still being authenticated concurrently to the invokation of this slot, but
+    // the credentials of the connecting process are available from the socket so objects can be
+    // registered immediately. No messages are dispatched until authentication completes.
+    const auto connectionName = connection.name();
+    const auto peer = m_connections.insert(connection);
+
+    // A single virtual object routes calls to all the host objects the connection is
+    // authorized to use.
+    if (!connection.registerVirtualObject(
+                QStringLiteral("/"), &m_connections, QDBusConnection::SubPath)) {
+        qCWarning(daemon, "Failed to register objects on connection %s", qPrintable(connectionName));
     }
 
-    const auto connectionName = connection.name();
+    if (m_deferredConnections.isEmpty() && admitConnection()) {
+        registerConnection(peer);
+    } else {
+        qCDebug(daemon, "Connection rate exceeded, deferring %s", qPrintable(connectionName));
 
-    for (const auto object : m_objects) {
-        if (object->authorizeConnection(connection)) {
-            registerObject(connection, object->path(), object);
+        peer->admitted = false;
+        m_deferredConnections.append(connectionName);
+
+        if (!m_deferralTimer.isActive()) {
+            admitDeferredConnections();
+        }
+    }
+}
+
+void HostService::registerConnection(HostConnections::Peer *peer)
+{
+    const auto connectionName = peer->connection.name();
+
+    for (int i = 0; i < m_objects.count(); ++i) {
+        const auto object = m_objects.at(i);
+
+        if (object->authorizeConnection(peer->connection)) {
+            peer->objects |= 1u << i;
             object->clientConnected(connectionName);
         }
     }
 }
 
+void HostService::admitDeferredConnections()
+{
+    while (!m_deferredConnections.isEmpty() && admitConnection()) {
+        const auto peer = m_connections.find(m_deferredConnections.takeFirst());
+        if (!peer || peer->admitted) {
+            continue;
+        }
+
+        peer->admitted = true;
+        registerConnection(peer);
+
+        // Calls which arrived while the connection was waiting are replayed in order. A
+        // client may disconnect and invalidate the peer in the process so work from copies.
+        const QDBusConnection connection = peer->connection;
+        const QVector<QDBusMessage> messages = peer->deferredMessages;
+        peer->deferredMessages.clear();
+
+        for (const QDBusMessage &message : messages) {
+            if (!m_connections.handleMessage(message, connection)
+                    && message.type() == QDBusMessage::MethodCallMessage
+                    && message.isReplyRequired()) {
+                connection.send(message.createErrorReply(
+                            QDBusError::UnknownObject,
+                            QStringLiteral("No such object path '%1'").arg(message.path())));
+            }
+        }
+    }
+
+    if (!m_deferredConnections.isEmpty()) {
+        // Wait until there is enough credit to admit the next connection.
+        m_deferralTimer.start(m_admissionLimiter.delay());
+    }
+}
+
+void HostService::dropConnection(const QString &connectionName)
+{
+    if (!m_connections.find(connectionName)) {
+        return;
+    }
+
+    if (const auto monitor = findChild<ConnectionMonitor *>(connectionName, Qt::FindDirectChildrenOnly)) {
+        monitor->disconnected();
+    } else {
+        m_deferredConnections.removeOne(connectionName);
+        m_connections.take(connectionName);
+
+        QDBusConnection::disconnectFromPeer(connectionName);
+    }
+}
+
+bool HostService::admitConnection()
+{
+    // Connections are admitted at a bounded rate with an allowance for short bursts.  When all
+    // clients reconnect after a restart the excess wait their turn rather than all being served
+    // at once.
+    return m_admissionLimiter.admit(m_admissionTimer.restart());
+}
+
 QString HostService::socketAddress()
 {
     // Check if socket-based activation logic is enabled and at least one fd is provided
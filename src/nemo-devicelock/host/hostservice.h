@@ -34,6 +34,12 @@
 #define NEMODEVICELOCK_HOSTSERVICE_H
 
 #include <QDBusServer>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTimer>
+
+#include "admissionlimiter.h"
+#include "hostconnections.h"
 
 #include <QVector>
 
@@ -69,10 +75,19 @@ private:
     friend class ConnectionMonitor;
 
     void connectionReady(const QDBusConnection &connection);
+    void registerConnection(HostConnections::Peer *peer);
+    bool admitConnection();
+    void admitDeferredConnections();
+    void dropConnection(const QString &connectionName);
     static QString socketAddress();
     void nameLost(const QString &name);
 
     const QVector<HostObject *> m_objects;
+    HostConnections m_connections;
+    QStringList m_deferredConnections;
+    QElapsedTimer m_admissionTimer;
+    QTimer m_deferralTimer;
+    AdmissionLimiter m_admissionLimiter;
 };
 
 }
@@ -38,7 +38,6 @@
 #include <QDBusMessage>
 #include <QDBusPendingReply>
 #include <QDebug>
-#include <QFileInfo>
 
 #include <sys/time.h>
 #include <mce/dbus-names.h>
@@ -63,15 +62,22 @@ MceDeviceLock::MceDeviceLock(Authenticator::Methods allowedMethods, QObject *par
           QStringLiteral(MCE_SERVICE),
           QStringLiteral(MCE_REQUEST_PATH),
           QStringLiteral(MCE_REQUEST_IF))
+    , m_callerWatcher(nullptr)
     , m_locked(false)
     , m_callActive(false)
     , m_displayOn(true)
     , m_tklockActive(true)
     , m_userActivity(true)
     , m_lpmMode(false)
+    , m_pendingChanges(0)
+    , m_avoidedEvaluations(0)
 {
     connect(&m_hbTimer, &BackgroundActivity::running, this, &MceDeviceLock::lock);
 
+    m_evaluationTimer.setSingleShot(true);
+    m_evaluationTimer.setInterval(0);
+    connect(&m_evaluationTimer, &QTimer::timeout, this, &MceDeviceLock::evaluateLockState);
+
     trackMceProperty(
                 QStringLiteral(MCE_CALL_STATE_SIG),
                 SLOT(handleCallStateChanged(QString)),
@@ -149,7 +155,7 @@ void MceDeviceLock::handleTklockStateChanged(const QString &state)
         qCDebug(daemon, "MCE tklock state is now %s", qPrintable(state));
 
         m_tklockActive = active;
-        setStateAndSetupLockTimer();
+        scheduleLockEvaluation();
     }
 }
 
@@ -163,7 +169,7 @@ void MceDeviceLock::handleCallStateChanged(const QString &state)
         qCDebug(daemon, "MCE call state is now %s", qPrintable(state));
 
         m_callActive = active;
-        setStateAndSetupLockTimer();
+        scheduleLockEvaluation();
     }
 }
 
@@ -177,7 +183,7 @@ void MceDeviceLock::handleDisplayStateChanged(const QString &state)
         qCDebug(daemon, "MCE display state is now %s", qPrintable(state));
 
         m_displayOn = displayOn;
-        setStateAndSetupLockTimer();
+        scheduleLockEvaluation();
     }
 }
 
@@ -191,7 +197,7 @@ void MceDeviceLock::handleInactivityStateChanged(const bool state)
         qCDebug(daemon, "MCE inactivity state is now %s", activity ? "true" : "false");
 
         m_userActivity = activity;
-        setStateAndSetupLockTimer();
+        scheduleLockEvaluation();
     }
 }
 
@@ -205,10 +211,33 @@ void MceDeviceLock::handleLpmModeChanged(const QString &state)
         qCDebug(daemon, "MCE LPM mode is now %s", lpmMode ? "true" : "false");
 
         m_lpmMode = lpmMode;
-        setStateAndSetupLockTimer();
+        scheduleLockEvaluation();
+    }
+}
+
+/** Defer evaluation of the lock state until the current batch of MCE signals is handled
+ */
+void MceDeviceLock::scheduleLockEvaluation()
+{
+    if (m_pendingChanges++ == 0) {
+        m_evaluationTimer.start();
+    } else {
+        ++m_avoidedEvaluations;
     }
 }
 
+/** Evaluate the lock state once for all MCE changes received since the last evaluation
+ */
+void MceDeviceLock::evaluateLockState()
+{
+    qCDebug(daemon, "Evaluating lock state for %d MCE changes, %d evaluations avoided by coalescing changes",
+                m_pendingChanges, m_avoidedEvaluations);
+
+    m_pendingChanges = 0;
+
+    setStateAndSetupLockTimer();
+}
+
 /** Helper for producing human readable devicelock state logging
  */
 static const char *reprLockState(bool locked)
@@ -391,11 +420,9 @@ void MceDeviceLockAdaptor::activateTemporaryLockout()
         return;
     }
 
-    uint callerServicePid(m_deviceLock->connection().interface()->servicePid(m_deviceLock->message().service()).value());
-    QFileInfo info(QString("/proc/%1").arg(callerServicePid));
-    bool callerIsRoot(info.owner() == "root");
-    if (!callerIsRoot) {
-        m_deviceLock->sendErrorReply(QDBusError::AccessDenied, QString("PID %1 euid is not root").arg(callerServicePid));
+    const QString caller = m_deviceLock->message().service();
+    if (m_deviceLock->callerUid(caller) != 0) {
+        m_deviceLock->sendErrorReply(QDBusError::AccessDenied, QString("%1 euid is not root").arg(caller));
         return;
     }
 
@@ -421,4 +448,37 @@ void MceDeviceLockAdaptor::activateTemporaryLockout()
         emit m_deviceLock->temporaryLockoutRequest();
 }
 
+uint MceDeviceLock::callerUid(const QString &service)
+{
+    const auto it = m_callerUids.constFind(service);
+    if (it != m_callerUids.constEnd()) {
+        return *it;
+    }
+
+    const QDBusConnection connection = HostObject::connection();
+    const QDBusReply<uint> reply = connection.interface()->serviceUid(service);
+    if (!reply.isValid()) {
+        return uint(-1);
+    }
+
+    // Unique bus names are never reused so the credentials of a caller can be kept until it
+    // disconnects. A well known name can move to another process so it's never cached.
+    if (service.startsWith(QLatin1Char(':'))) {
+        if (!m_callerWatcher) {
+            m_callerWatcher = new QDBusServiceWatcher(
+                        QString(), connection, QDBusServiceWatcher::WatchForUnregistration, this);
+            connect(m_callerWatcher, &QDBusServiceWatcher::serviceUnregistered,
+                    this, [this](const QString &service) {
+                m_callerUids.remove(service);
+                m_callerWatcher->removeWatchedService(service);
+            });
+        }
+
+        m_callerWatcher->addWatchedService(service);
+        m_callerUids.insert(service, reply.value());
+    }
+
+    return reply.value();
+}
+
 }
@@ -39,6 +39,9 @@
 #include <QDBusAbstractAdaptor>
 #include <QDBusContext>
 #include <QDBusPendingCallWatcher>
+#include <QDBusServiceWatcher>
+#include <QHash>
+#include <QTimer>
 #include <keepalive/backgroundactivity.h>
 #include <nemo-dbus/interface.h>
 
@@ -121,14 +124,25 @@ private:
             const QString &getMethod,
             void (MceDeviceLock::*replySlot)(const QString &));
 
+    void scheduleLockEvaluation();
+    void evaluateLockState();
     void setStateAndSetupLockTimer();
     bool getRequiredLockState();
     bool needLockTimer();
 
+    uint callerUid(const QString &service);
+
     MceDeviceLockAdaptor m_adaptor;
     NemoDBus::Interface m_mceRequest;
 
     BackgroundActivity m_hbTimer;
+    QTimer m_evaluationTimer;
+
+    QHash<QString, uint> m_callerUids;
+    QDBusServiceWatcher *m_callerWatcher;
+
+    int m_pendingChanges;
+    int m_avoidedEvaluations;
 
     bool m_locked;
     bool m_callActive;
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "randompool.h"
+
+#include "hostobject.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace NemoDeviceLock
+{
+
+RandomPool *RandomPool::sharedInstance = nullptr;
+
+RandomPool::RandomPool()
+    : m_position(sizeof(m_bytes))
+{
+    Q_ASSERT(!sharedInstance);
+    sharedInstance = this;
+}
+
+RandomPool::~RandomPool()
+{
+    memset(m_bytes, 0, sizeof(m_bytes));
+
+    sharedInstance = nullptr;
+}
+
+RandomPool *RandomPool::instance()
+{
+    return sharedInstance ? sharedInstance : new RandomPool;
+}
+
+bool RandomPool::next(quint8 *byte)
+{
+    if (m_position == sizeof(m_bytes) && !fill()) {
+        return false;
+    }
+
+    *byte = m_bytes[m_position];
+    m_bytes[m_position++] = 0;
+    return true;
+}
+
+bool RandomPool::fill()
+{
+    size_t filled = 0;
+#if defined(SYS_getrandom)
+    while (filled < sizeof(m_bytes)) {
+        const ssize_t count = syscall(SYS_getrandom, m_bytes + filled, sizeof(m_bytes) - filled, 0);
+        if (count > 0) {
+            filled += count;
+        } else if (count < 0 && errno != EINTR) {
+            break;
+        }
+    }
+#endif
+
+    if (filled < sizeof(m_bytes)) {
+        // getrandom() is unavailable, urandom is the non blocking equivalent.
+        const int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+        while (fd >= 0 && filled < sizeof(m_bytes)) {
+            const ssize_t count = read(fd, m_bytes + filled, sizeof(m_bytes) - filled);
+            if (count > 0) {
+                filled += count;
+            } else if (count == 0 || errno != EINTR) {
+                break;
+            }
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    if (filled < sizeof(m_bytes)) {
+        // Never hand out a partially filled block, the remainder would be zeros.
+        memset(m_bytes, 0, filled);
+        qCWarning(daemon, "Failed to read random data for security code generation");
+        return false;
+    }
+
+    m_position = 0;
+    return true;
+}
+
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "securitycodefilter.h"
+
+#include "hostobject.h"
+
+#include <QFile>
+#include <QSettings>
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace NemoDeviceLock
+{
+
+struct BlocklistHeader
+{
+    enum {
+        Magic = 0x424c444e, // NDLB
+        Version = 1
+    };
+
+    quint32 magic;
+    quint32 version;
+    quint64 count;
+};
+
+SecurityCodeFilter *SecurityCodeFilter::sharedInstance = nullptr;
+
+SecurityCodeFilter::SecurityCodeFilter()
+    : m_mapping(nullptr)
+    , m_mappingSize(0)
+    , m_blocklist(nullptr)
+    , m_blocklistCount(0)
+    , m_maximumRepeat(0)
+    , m_maximumSequence(0)
+{
+    Q_ASSERT(!sharedInstance);
+    sharedInstance = this;
+
+    QSettings settings(QStringLiteral("/usr/share/lipstick/devicelock/devicelock.conf"), QSettings::IniFormat);
+
+    m_maximumRepeat = settings.value(QStringLiteral("DeviceLock/weakCodeMaximumRepeat"), 0).toInt();
+    m_maximumSequence = settings.value(QStringLiteral("DeviceLock/weakCodeMaximumSequence"), 0).toInt();
+
+    const QString blocklist = settings.value(QStringLiteral("DeviceLock/weakCodeBlocklist")).toString();
+    if (blocklist.isEmpty()) {
+        return;
+    }
+
+    const int fd = open(QFile::encodeName(blocklist).constData(), O_RDONLY | O_CLOEXEC);
+
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0) {
+        qCWarning(daemon, "DeviceLock: Failed to open the weak code blocklist %s", qPrintable(blocklist));
+    } else if (status.st_size < off_t(sizeof(BlocklistHeader))
+            || (status.st_size - sizeof(BlocklistHeader)) % sizeof(quint64) != 0) {
+        qCWarning(daemon, "DeviceLock: Invalid weak code blocklist %s", qPrintable(blocklist));
+    } else {
+        void * const memory = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+        if (memory == MAP_FAILED) {
+            qCWarning(daemon, "DeviceLock: Failed to map the weak code blocklist %s", qPrintable(blocklist));
+        } else {
+            m_mapping = memory;
+            m_mappingSize = status.st_size;
+
+            const BlocklistHeader * const header = static_cast<const BlocklistHeader *>(memory);
+            const quint64 * const hashes = reinterpret_cast<const quint64 *>(header + 1);
+            const size_t count = (status.st_size - sizeof(BlocklistHeader)) / sizeof(quint64);
+
+            // A table which isn't sorted can't be searched, rather than miss entries don't use it.
+            if (header->magic != BlocklistHeader::Magic
+                    || header->version != BlocklistHeader::Version
+                    || header->count != count
+                    || !std::is_sorted(hashes, hashes + count)) {
+                qCWarning(daemon, "DeviceLock: Invalid weak code blocklist %s", qPrintable(blocklist));
+            } else {
+                m_blocklist = hashes;
+                m_blocklistCount = count;
+            }
+        }
+    }
+
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+SecurityCodeFilter::~SecurityCodeFilter()
+{
+    if (m_mapping) {
+        munmap(m_mapping, m_mappingSize);
+    }
+
+    sharedInstance = nullptr;
+}
+
+SecurityCodeFilter *SecurityCodeFilter::instance()
+{
+    return sharedInstance ? sharedInstance : new SecurityCodeFilter;
+}
+
+bool SecurityCodeFilter::isWeak(const QString &code) const
+{
+    return exceedsMaximumRepeat(code)
+            || exceedsMaximumSequence(code)
+            || isBlocked(code.toUtf8());
+}
+
+quint64 SecurityCodeFilter::hash(const QByteArray &code)
+{
+    quint64 hash = Q_UINT64_C(14695981039346656037);
+    for (const char character : code) {
+        hash ^= quint8(character);
+        hash *= Q_UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+bool SecurityCodeFilter::isBlocked(const QByteArray &code) const
+{
+    return m_blocklist && std::binary_search(m_blocklist, m_blocklist + m_blocklistCount, hash(code));
+}
+
+bool SecurityCodeFilter::exceedsMaximumRepeat(const QString &code) const
+{
+    if (m_maximumRepeat <= 0) {
+        return false;
+    }
+
+    int repeat = 1;
+    for (int i = 1; i < code.length(); ++i) {
+        repeat = code.at(i) == code.at(i - 1) ? repeat + 1 : 1;
+
+        if (repeat > m_maximumRepeat) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SecurityCodeFilter::exceedsMaximumSequence(const QString &code) const
+{
+    if (m_maximumSequence <= 0) {
+        return false;
+    }
+
+    // Counts runs of consecutive characters in either direction, i.e. 1234 or 9876.
+    int sequence = 1;
+    int step = 0;
+    for (int i = 1; i < code.length(); ++i) {
+        const int difference = code.at(i).unicode() - code.at(i - 1).unicode();
+
+        if ((difference == 1 || difference == -1) && (sequence == 1 || difference == step)) {
+            ++sequence;
+        } else if (difference == 1 || difference == -1) {
+            sequence = 2;
+        } else {
+            sequence = 1;
+        }
+        step = difference;
+
+        if (sequence > m_maximumSequence) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef NEMODEVICELOCK_SECURITYCODEFILTER_H
+#define NEMODEVICELOCK_SECURITYCODEFILTER_H
+
+#include <QSharedData>
+#include <QString>
+
+namespace NemoDeviceLock
+{
+
+/*
+    Rejects new security codes which are trivially guessable before they're passed to the
+    expensive set code operation of a backend.
+
+    A code is weak if it is in the blocklist or breaks one of the pattern rules configured in
+    devicelock.conf.  The blocklist is a file which is mapped into memory and binary searched.  It
+    starts with a header of the magic number NDLB, a version of 1 and the number of entries as
+    32, 32 and 64 bit integers, followed by that many sorted 64 bit FNV-1a hashes of the UTF-8
+    encoded codes, all in host byte order.  A file which doesn't match its header is ignored.
+
+    Only hashes are stored so a code which merely shares the hash of a listed code is rejected
+    too.  With 64 bit hashes that is vanishingly unlikely for any realistic list.
+*/
+class SecurityCodeFilter : public QSharedData
+{
+public:
+    ~SecurityCodeFilter();
+
+    static SecurityCodeFilter *instance();
+
+    bool isWeak(const QString &code) const;
+
+    static quint64 hash(const QByteArray &code);
+
+private:
+    SecurityCodeFilter();
+
+    inline bool isBlocked(const QByteArray &code) const;
+    inline bool exceedsMaximumRepeat(const QString &code) const;
+    inline bool exceedsMaximumSequence(const QString &code) const;
+
+    void *m_mapping;
+    size_t m_mappingSize;
+    const quint64 *m_blocklist;
+    size_t m_blocklistCount;
+    int m_maximumRepeat;
+    int m_maximumSequence;
+
+    static SecurityCodeFilter *sharedInstance;
+};
+
+}
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "verificationexecutor.h"
+
+#include "hostauthenticationinput.h"
+
+#include <QThread>
+
+namespace NemoDeviceLock
+{
+
+VerificationTask::VerificationTask(
+        const std::function<int()> &verification,
+        QObject *context,
+        const std::function<void(int result)> &finished)
+    : m_verification(verification)
+    , m_finished(finished)
+    , m_context(context)
+    , m_canceled(0)
+    , m_delivered(false)
+{
+    setAutoDelete(false);
+
+    connect(this, &VerificationTask::completed,
+            this, &VerificationTask::workerCompleted, Qt::QueuedConnection);
+}
+
+VerificationTask::~VerificationTask()
+{
+}
+
+void VerificationTask::cancel()
+{
+    if (m_canceled.testAndSetOrdered(0, 1)) {
+        // Deliver the failure from the event loop so the caller can finish updating its state
+        // first, the same as it would for a result from the worker.
+        QMetaObject::invokeMethod(
+                    this, "deliver", Qt::QueuedConnection, Q_ARG(int, HostAuthenticationInput::Failure));
+    }
+}
+
+void VerificationTask::run()
+{
+    const int result = m_canceled.load()
+            ? int(HostAuthenticationInput::Failure)
+            : m_verification();
+
+    emit completed(result);
+}
+
+void VerificationTask::deliver(int result)
+{
+    if (!m_delivered) {
+        m_delivered = true;
+
+        if (m_context) {
+            m_finished(result);
+        }
+    }
+}
+
+void VerificationTask::workerCompleted(int result)
+{
+    if (!m_canceled.load()) {
+        deliver(result);
+    }
+
+    deleteLater();
+}
+
+VerificationExecutor *VerificationExecutor::sharedInstance = nullptr;
+
+VerificationExecutor::VerificationExecutor()
+{
+    Q_ASSERT(!sharedInstance);
+    sharedInstance = this;
+
+    // Verifications are deliberately expensive, running more of them concurrently than there are
+    // cores only delays all of them.
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), 2));
+}
+
+VerificationExecutor::~VerificationExecutor()
+{
+    // Tasks still queued are started so their completion can be delivered and they're deleted,
+    // canceled ones return without verifying.
+    m_pool.waitForDone();
+
+    sharedInstance = nullptr;
+}
+
+VerificationExecutor *VerificationExecutor::instance()
+{
+    return sharedInstance ? sharedInstance : new VerificationExecutor;
+}
+
+VerificationTask *VerificationExecutor::start(
+        const std::function<int()> &verification,
+        QObject *context,
+        const std::function<void(int result)> &finished)
+{
+    VerificationTask * const task = new VerificationTask(verification, context, finished);
+
+    m_pool.start(task);
+
+    return task;
+}
+
+}
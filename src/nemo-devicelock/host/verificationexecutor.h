@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef NEMODEVICELOCK_VERIFICATIONEXECUTOR_H
+#define NEMODEVICELOCK_VERIFICATIONEXECUTOR_H
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QPointer>
+#include <QRunnable>
+#include <QSharedData>
+#include <QThreadPool>
+
+#include <functional>
+
+namespace NemoDeviceLock
+{
+
+/*
+    A verification such as a key derivation running on a worker thread of the
+    VerificationExecutor.
+
+    A canceled verification delivers Failure without waiting for the worker.  If the work hasn't
+    started it is skipped, otherwise its result is discarded when it completes.
+*/
+class VerificationTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+public:
+    VerificationTask(
+            const std::function<int()> &verification,
+            QObject *context,
+            const std::function<void(int result)> &finished);
+    ~VerificationTask();
+
+    void cancel();
+
+    void run() override;
+
+signals:
+    void completed(int result);
+
+private slots:
+    void deliver(int result);
+    void workerCompleted(int result);
+
+private:
+    const std::function<int()> m_verification;
+    const std::function<void(int result)> m_finished;
+    const QPointer<QObject> m_context;
+    QAtomicInt m_canceled;
+    bool m_delivered;
+};
+
+/*
+    Runs time consuming security code verifications on a bounded pool of worker threads shared
+    by all the authentication inputs of the daemon and delivers the results to the thread of the
+    context object.
+*/
+class VerificationExecutor : public QSharedData
+{
+public:
+    ~VerificationExecutor();
+
+    static VerificationExecutor *instance();
+
+    VerificationTask *start(
+            const std::function<int()> &verification,
+            QObject *context,
+            const std::function<void(int result)> &finished);
+
+private:
+    VerificationExecutor();
+
+    QThreadPool m_pool;
+
+    static VerificationExecutor *sharedInstance;
+};
+
+}
+
+#endif
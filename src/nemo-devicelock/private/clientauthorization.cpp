@@ -57,7 +57,8 @@ ClientAuthorization::ClientAuthorization(
           this,
           hostPath,
           QStringLiteral("org.nemomobile.devicelock.Authorization"),
-          localPath)
+          localPath,
+          LazyConnection)
     , m_allowedMethods()
     , m_requestedMethods(Authenticator::AllAvailable)
     , m_authenticatingPid(QCoreApplication::applicationPid())
@@ -112,6 +113,10 @@ void ClientAuthorization::requestChallenge()
     if (m_status != RequestingChallenge) {
         m_status = RequestingChallenge;
 
+        // The host notifies of expired challenges over the connection so it needs to be kept
+        // open for as long as a challenge is held.
+        holdConnection(true);
+
         const auto response = call(
                     QStringLiteral("RequestChallenge"),
                     m_localPath,
@@ -151,6 +156,8 @@ void ClientAuthorization::requestChallenge()
             if (m_status == RequestingChallenge) {
                 m_status = NoChallenge;
 
+                holdConnection(false);
+
                 emit challengeDeclined();
                 emit statusChanged();
             }
@@ -165,6 +172,8 @@ void ClientAuthorization::relinquishChallenge()
 
         call(QStringLiteral("RelinquishChallenge"), m_localPath);
 
+        holdConnection(false);
+
         emit statusChanged();
     }
 }
@@ -174,6 +183,8 @@ void ClientAuthorization::handleChallengeExpired()
     if (m_status != NoChallenge) {
         m_status = NoChallenge;
 
+        holdConnection(false);
+
         emit challengeExpired();
         emit statusChanged();
     }
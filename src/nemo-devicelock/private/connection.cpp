@@ -32,15 +32,20 @@
 
 #include <connection.h>
 #include "private/logging.h"
+#include "private/objectdispatcher.h"
 
 #include <QCoreApplication>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+
+#include <random>
 
 namespace NemoDeviceLock
 {
 
 Connection *Connection::sharedInstance = nullptr;
 
-static QDBusConnection connectToHost()
+static QDBusConnection openHostConnection()
 {
     static int counter = 0;
 
@@ -49,36 +54,131 @@ static QDBusConnection connectToHost()
                 QStringLiteral("org.nemomobile.devicelock.%1").arg(counter++));
 }
 
+LocalObjects::LocalObjects(QObject *parent)
+    : QDBusVirtualObject(parent)
+    , m_rootPath(QStringLiteral("/%1").arg(QCoreApplication::applicationPid()))
+{
+}
+
+LocalObjects::~LocalObjects()
+{
+}
+
+QString LocalObjects::rootPath() const
+{
+    return m_rootPath;
+}
+
+QDBusObjectPath LocalObjects::insert(QObject *object)
+{
+    int index;
+    if (!m_freeSlots.isEmpty()) {
+        index = m_freeSlots.takeLast();
+    } else {
+        index = m_slots.count();
+        m_slots.append(Slot { nullptr, 0 });
+    }
+
+    Slot &slot = m_slots[index];
+    slot.object = object;
+
+    // The generation distinguishes successive objects in the same slot so a call meant for one
+    // which has been removed is never delivered to its replacement.
+    return QDBusObjectPath(m_rootPath + QLatin1Char('/') + QString::number(
+                (quint64(slot.generation) << 32) | quint32(index)));
+}
+
+void LocalObjects::remove(const QDBusObjectPath &path)
+{
+    const quint64 id = path.path().mid(m_rootPath.length() + 1).toULongLong();
+    const quint32 index = quint32(id);
+
+    if (index < quint32(m_slots.count()) && m_slots.at(index).object) {
+        Slot &slot = m_slots[index];
+        slot.object = nullptr;
+        ++slot.generation;
+
+        m_freeSlots.append(int(index));
+    }
+}
+
+QObject *LocalObjects::find(const QString &path) const
+{
+    if (path.length() <= m_rootPath.length() + 1
+            || !path.startsWith(m_rootPath)
+            || path.at(m_rootPath.length()) != QLatin1Char('/')) {
+        return nullptr;
+    }
+
+    bool ok = false;
+    const quint64 id = path.midRef(m_rootPath.length() + 1).toULongLong(&ok);
+    const quint32 index = quint32(id);
+
+    return ok && index < quint32(m_slots.count()) && m_slots.at(index).generation == id >> 32
+            ? m_slots.at(index).object
+            : nullptr;
+}
+
+bool LocalObjects::handleMessage(const QDBusMessage &message, const QDBusConnection &connection)
+{
+    QObject * const object = find(message.path());
+
+    return object && dispatchToAdaptor(object, message, connection);
+}
+
+QString LocalObjects::introspect(const QString &path) const
+{
+    QObject * const object = find(path);
+
+    return object ? introspectAdaptors(object) : QString();
+}
+
 Connection::Connection(QObject *parent)
     : QObject(parent)
-    , NemoDBus::Connection(connectToHost(), devicelock_dbus())
-    , m_serviceWatcher(
-        QStringLiteral("org.nemomobile.devicelock"),
-        QDBusConnection::systemBus(),
-        QDBusServiceWatcher::WatchForRegistration)
+    , NemoDBus::Connection(QDBusConnection(QString()), devicelock_dbus())
+    , m_serviceWatcher(nullptr)
+    , m_pins(0)
+    , m_reconnectAttempts(0)
 {
     Q_ASSERT(!sharedInstance);
     sharedInstance = this;
 
-    if (!isConnected()) {
-        qCWarning(devicelock, "Failed to connect to host.");
-    }
+    // Clients which only make the occasional method call don't need to hold a connection to the
+    // daemon between calls, if nothing has pinned the connection it is closed after being idle
+    // for longer than a call can be pending.
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(30000);
 
-    connect(&m_serviceWatcher, &QDBusServiceWatcher::serviceRegistered, this, [this](const QString &) {
-        if (!isConnected()) {
-            qCDebug(devicelock, "The device lock socket is available to connect to");
+    QObject::connect(&m_idleTimer, &QTimer::timeout, this, [this] {
+        if (m_pins == 0) {
+            disconnectFromHost();
+        }
+    });
+
+    m_reconnectTimer.setSingleShot(true);
+
+    QObject::connect(&m_reconnectTimer, &QTimer::timeout, this, [this] {
+        if (m_pins > 0 && !connection().isConnected()) {
+            connectToHost();
 
-            if (!reconnect(connectToHost())) {
-                qCWarning(devicelock, "Failed to reconnect to host. %s",
-                            qPrintable(connection().lastError().message()));
+            if (!connection().isConnected()) {
+                scheduleReconnect();
             }
         }
     });
+
+    onConnected(this, [this] {
+        m_reconnectAttempts = 0;
+    });
+
+    onDisconnected(this, [this] {
+        scheduleReconnect();
+    });
 }
 
 Connection::~Connection()
 {
-    QDBusConnection::disconnectFromPeer(connection().name());
+    disconnectFromHost();
 
     sharedInstance = nullptr;
 }
@@ -88,34 +188,333 @@ Connection *Connection::instance()
     return sharedInstance ? sharedInstance : new Connection;
 }
 
-ConnectionClient::ConnectionClient(QObject *context, const QString &path, const QString &interface)
-    : ConnectionClient(context, path, interface, generateLocalPath())
+void Connection::activate()
+{
+    if (!connection().isConnected()) {
+        connectToHost();
+    }
+
+    if (m_pins == 0) {
+        m_idleTimer.start();
+    }
+}
+
+void Connection::pin()
+{
+    if (++m_pins == 1) {
+        m_idleTimer.stop();
+    }
+
+    if (!connection().isConnected()) {
+        connectToHost();
+    }
+}
+
+void Connection::release()
+{
+    if (--m_pins == 0 && connection().isConnected()) {
+        m_idleTimer.start();
+    }
+}
+
+void Connection::connectToHost()
+{
+    if (!m_serviceWatcher) {
+        m_serviceWatcher = new QDBusServiceWatcher(
+                    QStringLiteral("org.nemomobile.devicelock"),
+                    QDBusConnection::systemBus(),
+                    QDBusServiceWatcher::WatchForRegistration,
+                    this);
+
+        QObject::connect(m_serviceWatcher, &QDBusServiceWatcher::serviceRegistered, this, [this](const QString &) {
+            qCDebug(devicelock, "The device lock socket is available to connect to");
+
+            // Restart a backed off reconnect, the daemon is ready for it now.
+            m_reconnectAttempts = 0;
+            m_reconnectTimer.stop();
+
+            scheduleReconnect();
+        });
+    }
+
+    if (!reconnect(openHostConnection())) {
+        qCWarning(devicelock, "Failed to connect to host. %s",
+                    qPrintable(connection().lastError().message()));
+    }
+}
+
+QDBusObjectPath Connection::insertLocalObject(QObject *object)
+{
+    return m_localObjects.insert(object);
+}
+
+void Connection::removeLocalObject(const QDBusObjectPath &path)
+{
+    m_localObjects.remove(path);
+}
+
+void Connection::exportLocalObjects()
+{
+    QDBusConnection connection = this->connection();
+
+    if (connection.isConnected() && m_localObjectsConnection != connection.name()) {
+        m_localObjectsConnection = connection.name();
+
+        if (!connection.registerVirtualObject(
+                    m_localObjects.rootPath(), &m_localObjects, QDBusConnection::SubPath)) {
+            qCWarning(devicelock, "Failed to register the local objects of the process");
+        }
+    }
+}
+
+void Connection::scheduleReconnect()
+{
+    // Only reconnect clients which need to be connected, the others will connect with their
+    // next call.
+    if (m_pins == 0 || m_reconnectTimer.isActive()) {
+        return;
+    }
+
+    // Every client is notified of a restart of the daemon at the same time, spread their
+    // reconnects out over a random interval which doubles with every attempt so the daemon
+    // isn't overwhelmed or can catch up if it turns connections away.
+    static std::mt19937 generator { std::random_device()() };
+
+    const int interval = 250 << qMin(m_reconnectAttempts++, 6);
+
+    m_reconnectTimer.start(std::uniform_int_distribution<int>(0, interval)(generator));
+}
+
+void Connection::disconnectFromHost()
+{
+    const QString name = connection().name();
+
+    if (!name.isEmpty()) {
+        qCDebug(devicelock, "Disconnecting from idle host connection %s", qPrintable(name));
+
+        QDBusConnection::disconnectFromPeer(name);
+    }
+}
+
+static const QString propertiesInterface = QStringLiteral("org.freedesktop.DBus.Properties");
+
+QHash<PropertyCache::Key, PropertyCache *> PropertyCache::instances;
+
+PropertyCache::PropertyCache(Connection *connection, const QString &path, const QString &interface)
+    : m_connection(connection)
+    , m_path(path)
+    , m_interface(interface)
+    , m_updateQueued(false)
+    , m_fetching(false)
+{
+    instances.insert(Key(connection, qMakePair(path, interface)), this);
+}
+
+PropertyCache::~PropertyCache()
+{
+    instances.remove(Key(m_connection.data(), qMakePair(m_path, m_interface)));
+}
+
+PropertyCache *PropertyCache::instance(Connection *connection, const QString &path, const QString &interface)
+{
+    const auto cache = instances.value(Key(connection, qMakePair(path, interface)));
+
+    return cache ? cache : new PropertyCache(connection, path, interface);
+}
+
+void PropertyCache::subscribe(
+        const void *owner, const QString &property, const std::function<void(const QVariant &value)> &handler)
+{
+    // Subscriptions are renewed on every connection, replace rather than duplicate handlers.
+    bool replaced = false;
+    for (Listener &listener : m_listeners) {
+        if (listener.owner == owner && listener.property == property) {
+            listener.handler = handler;
+            listener.initialized = false;
+            replaced = true;
+            break;
+        }
+    }
+
+    if (!replaced) {
+        const Listener listener = { owner, property, handler, false };
+        m_listeners.append(listener);
+    }
+
+    if (!m_updateQueued) {
+        m_updateQueued = true;
+
+        QTimer::singleShot(0, this, [this] {
+            m_updateQueued = false;
+
+            update();
+        });
+    }
+}
+
+void PropertyCache::unsubscribe(const void *owner)
+{
+    for (int i = m_listeners.count() - 1; i >= 0; --i) {
+        if (m_listeners.at(i).owner == owner) {
+            m_listeners.remove(i);
+        }
+    }
+}
+
+void PropertyCache::update()
+{
+    QDBusConnection connection = m_connection->connection();
+
+    if (!connection.isConnected()) {
+        return;
+    } else if (m_connectionName == connection.name()) {
+        // The cached values are current, new subscribers can be given them without asking the
+        // host. If a fetch is in progress they'll receive its result instead.
+        if (!m_fetching) {
+            propertiesReceived(m_values, true);
+        }
+        return;
+    }
+
+    m_connectionName = connection.name();
+    m_values.clear();
+    m_fetching = true;
+
+    connection.connect(
+                QString(),
+                m_path,
+                propertiesInterface,
+                QStringLiteral("PropertiesChanged"),
+                this,
+                SLOT(propertiesChanged(QString,QVariantMap,QStringList)));
+
+    QDBusMessage message = QDBusMessage::createMethodCall(
+                QString(), m_path, propertiesInterface, QStringLiteral("GetAll"));
+    message.setArguments(QVariantList() << m_interface);
+
+    const auto watcher = new QDBusPendingCallWatcher(connection.asyncCall(message), this);
+
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+
+        m_fetching = false;
+
+        const QDBusPendingReply<QVariantMap> reply = *watcher;
+        if (reply.isError()) {
+            qCWarning(devicelock, "Failed to get the properties of %s %s. %s",
+                        qPrintable(m_path), qPrintable(m_interface), qPrintable(reply.error().message()));
+        } else {
+            m_values = reply.value();
+
+            propertiesReceived(m_values, false);
+        }
+    });
+}
+
+void PropertyCache::propertiesChanged(
+        const QString &interface, const QVariantMap &changed, const QStringList &invalidated)
+{
+    Q_UNUSED(invalidated);
+
+    if (interface == m_interface) {
+        for (auto it = changed.begin(); it != changed.end(); ++it) {
+            m_values.insert(it.key(), it.value());
+        }
+
+        propertiesReceived(changed, false);
+    }
+}
+
+void PropertyCache::propertiesReceived(const QVariantMap &properties, bool initialize)
+{
+    // A handler may release the last reference to the cache, keep it alive until all have been
+    // invoked.
+    const QExplicitlySharedDataPointer<PropertyCache> cache(this);
+
+    // Handlers are invoked in the order they were subscribed, and may subscribe or unsubscribe
+    // others so they're invoked from a copy.
+    const QVector<Listener> listeners = m_listeners;
+
+    // A listener is only initialized once it has received a value, a change to other
+    // properties doesn't deliver the current value of its own.
+    for (Listener &listener : m_listeners) {
+        if (properties.contains(listener.property)) {
+            listener.initialized = true;
+        }
+    }
+
+    for (const Listener &listener : listeners) {
+        if (initialize && listener.initialized) {
+            continue;
+        }
+
+        const auto it = properties.find(listener.property);
+        if (it != properties.end() && isSubscribed(listener.owner, listener.property)) {
+            listener.handler(*it);
+        }
+    }
+}
+
+bool PropertyCache::isSubscribed(const void *owner, const QString &property) const
+{
+    for (const Listener &listener : m_listeners) {
+        if (listener.owner == owner && listener.property == property) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ConnectionClient::ConnectionClient(
+        QObject *context, const QString &path, const QString &interface, ConnectionMode mode)
+    : ConnectionClient(context, path, interface, Connection::instance()->insertLocalObject(context), mode)
 {
+    m_ownsLocalPath = true;
 }
 
 ConnectionClient::ConnectionClient(
         QObject *context,
         const QString &path,
         const QString &interface,
-        const QDBusObjectPath &localPath)
+        const QDBusObjectPath &localPath,
+        ConnectionMode mode)
     : NemoDBus::Interface(context, *Connection::instance(), QString(), path, interface)
     , m_connection(Connection::instance())
     , m_localPath(localPath)
+    , m_interfaceName(interface)
+    , m_holdingConnection(false)
+    , m_ownsLocalPath(false)
 {
+    holdConnection(mode == PersistentConnection);
 }
 
-void ConnectionClient::registerObject()
+ConnectionClient::~ConnectionClient()
 {
-    m_connection->registerObject(m_localPath.path(), context());
+    if (m_properties) {
+        m_properties->unsubscribe(this);
+    }
+
+    holdConnection(false);
+
+    if (m_ownsLocalPath) {
+        m_connection->removeLocalObject(m_localPath);
+    }
 }
 
-QDBusObjectPath ConnectionClient::generateLocalPath()
+void ConnectionClient::registerObject()
 {
-    static const auto pid = QCoreApplication::applicationPid();
-    static int objectCounter = 0;
+    m_connection->exportLocalObjects();
+}
 
-    return QDBusObjectPath(QStringLiteral("/%1/%2").arg(
-                QString::number(pid), QString::number(++objectCounter)));
+void ConnectionClient::holdConnection(bool hold)
+{
+    if (hold && !m_holdingConnection) {
+        m_holdingConnection = true;
+        m_connection->pin();
+    } else if (!hold && m_holdingConnection) {
+        m_holdingConnection = false;
+        m_connection->release();
+    }
 }
 
 }
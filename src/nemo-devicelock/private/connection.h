@@ -35,12 +35,53 @@
 
 #include <nemo-dbus/interface.h>
 
+#include <QDBusArgument>
 #include <QDBusObjectPath>
 #include <QDBusServiceWatcher>
+#include <QDBusVirtualObject>
+#include <QHash>
+#include <QTimer>
+#include <QVector>
+
+#include <functional>
 
 namespace NemoDeviceLock
 {
 
+/*
+    Routes calls to the /<pid>/<id> objects of client instances.  A single virtual object is
+    registered for the sub tree of the process and instances are looked up by the index in the
+    id, the remaining bits of the id are a generation count so a call for an instance which has
+    been destroyed isn't delivered to a new instance reusing its index.
+*/
+class LocalObjects : public QDBusVirtualObject
+{
+public:
+    explicit LocalObjects(QObject *parent = nullptr);
+    ~LocalObjects();
+
+    QString rootPath() const;
+
+    QDBusObjectPath insert(QObject *object);
+    void remove(const QDBusObjectPath &path);
+
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override;
+    QString introspect(const QString &path) const override;
+
+private:
+    struct Slot
+    {
+        QObject *object;
+        quint32 generation;
+    };
+
+    QObject *find(const QString &path) const;
+
+    QVector<Slot> m_slots;
+    QVector<int> m_freeSlots;
+    const QString m_rootPath;
+};
+
 class Connection : public QObject, public NemoDBus::Connection, public QSharedData
 {
 public:
@@ -48,32 +89,137 @@ public:
 
     static Connection *instance();
 
-private:
-    QDBusServiceWatcher m_serviceWatcher;
+    void activate();
+
+    void pin();
+    void release();
 
+    QDBusObjectPath insertLocalObject(QObject *object);
+    void removeLocalObject(const QDBusObjectPath &path);
+    void exportLocalObjects();
+
+private:
     explicit Connection(QObject *parent = nullptr);
 
+    void connectToHost();
+    void disconnectFromHost();
+    void scheduleReconnect();
+
+    LocalObjects m_localObjects;
+    QString m_localObjectsConnection;
+    QDBusServiceWatcher *m_serviceWatcher;
+    QTimer m_idleTimer;
+    QTimer m_reconnectTimer;
+    int m_pins;
+    int m_reconnectAttempts;
+
     static Connection *sharedInstance;
 };
 
+/*
+    A process wide cache of the properties of an interface of a host object.  All properties are
+    fetched with a single GetAll call and kept up to date from PropertiesChanged signals, every
+    client object subscribed to the same path and interface shares the one cache and subscription.
+*/
+class PropertyCache : public QObject, public QSharedData
+{
+    Q_OBJECT
+public:
+    ~PropertyCache();
+
+    static PropertyCache *instance(Connection *connection, const QString &path, const QString &interface);
+
+    void subscribe(
+            const void *owner,
+            const QString &property,
+            const std::function<void(const QVariant &value)> &handler);
+    void unsubscribe(const void *owner);
+
+private slots:
+    void propertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated);
+
+private:
+    struct Listener
+    {
+        const void *owner;
+        QString property;
+        std::function<void(const QVariant &value)> handler;
+        bool initialized;
+    };
+
+    PropertyCache(Connection *connection, const QString &path, const QString &interface);
+
+    typedef QPair<const Connection *, QPair<QString, QString>> Key;
+
+    void update();
+    void propertiesReceived(const QVariantMap &properties, bool initialize);
+    bool isSubscribed(const void *owner, const QString &property) const;
+
+    QExplicitlySharedDataPointer<Connection> m_connection;
+    QVector<Listener> m_listeners;
+    QVariantMap m_values;
+    const QString m_path;
+    const QString m_interface;
+    QString m_connectionName;
+    bool m_updateQueued;
+    bool m_fetching;
+
+    static QHash<Key, PropertyCache *> instances;
+};
+
 class ConnectionClient : public NemoDBus::Interface
 {
 protected:
-    ConnectionClient(QObject *context, const QString &path, const QString &interface);
+    enum ConnectionMode {
+        PersistentConnection,
+        LazyConnection
+    };
+
+    ConnectionClient(
+            QObject *context,
+            const QString &path,
+            const QString &interface,
+            ConnectionMode mode = PersistentConnection);
     ConnectionClient(
             QObject *context,
             const QString &path,
             const QString &interface,
-            const QDBusObjectPath &localPath);
-    virtual ~ConnectionClient() {}
+            const QDBusObjectPath &localPath,
+            ConnectionMode mode = PersistentConnection);
+    virtual ~ConnectionClient();
+
+    template <typename... Arguments>
+    NemoDBus::Response *call(const QString &method, Arguments... arguments)
+    {
+        m_connection->activate();
+
+        return NemoDBus::Interface::call(method, arguments...);
+    }
+
+    template <typename T, typename Handler>
+    void subscribeToProperty(const QString &property, const Handler &handler)
+    {
+        if (!m_properties) {
+            m_properties = PropertyCache::instance(m_connection.data(), path(), m_interfaceName);
+        }
+
+        m_properties->subscribe(this, property, [handler](const QVariant &value) {
+            handler(qdbus_cast<T>(value));
+        });
+    }
 
     void registerObject();
 
+    void holdConnection(bool hold);
+
     QExplicitlySharedDataPointer<Connection> m_connection;
     QDBusObjectPath m_localPath;
 
 private:
-    static QDBusObjectPath generateLocalPath();
+    const QString m_interfaceName;
+    QExplicitlySharedDataPointer<PropertyCache> m_properties;
+    bool m_holdingConnection;
+    bool m_ownsLocalPath;
 };
 
 }
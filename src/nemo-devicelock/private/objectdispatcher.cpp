@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "objectdispatcher.h"
+
+#include <QDBusAbstractAdaptor>
+#include <QDBusArgument>
+#include <QDBusMetaType>
+#include <QDBusVariant>
+#include <QMetaMethod>
+#include <QMetaProperty>
+
+namespace NemoDeviceLock
+{
+
+static const char *classInfo(const QMetaObject *metaObject, const char *name)
+{
+    const int index = metaObject->indexOfClassInfo(name);
+    return index != -1 ? metaObject->classInfo(index).value() : nullptr;
+}
+
+static QByteArray inputSignature(const QMetaMethod &method)
+{
+    QByteArray signature;
+
+    for (int i = 0; i < method.parameterCount(); ++i) {
+        const char * const type = QDBusMetaType::typeToSignature(method.parameterType(i));
+        if (!type) {
+            return QByteArray();
+        }
+        signature += type;
+    }
+
+    return signature;
+}
+
+static bool invoke(
+        QObject *adaptor,
+        const QMetaMethod &method,
+        const QDBusMessage &message,
+        const QDBusConnection &connection)
+{
+    enum { MaximumArguments = 10 };
+
+    const QVariantList arguments = message.arguments();
+    if (method.parameterCount() != arguments.count() || arguments.count() > MaximumArguments) {
+        return false;
+    }
+
+    QVariant values[MaximumArguments];
+    QGenericArgument parameters[MaximumArguments];
+    const QList<QByteArray> typeNames = method.parameterTypes();
+
+    for (int i = 0; i < arguments.count(); ++i) {
+        const int type = method.parameterType(i);
+
+        values[i] = arguments.at(i);
+
+        if (values[i].userType() == qMetaTypeId<QDBusArgument>()) {
+            const QDBusArgument argument = qvariant_cast<QDBusArgument>(values[i]);
+
+            values[i] = QVariant(type, nullptr);
+            if (!QDBusMetaType::demarshall(argument, type, values[i].data())) {
+                return false;
+            }
+        } else if (values[i].userType() != type) {
+            return false;
+        }
+
+        parameters[i] = QGenericArgument(typeNames.at(i).constData(), values[i].constData());
+    }
+
+    QVariant result;
+    QGenericReturnArgument returnArgument;
+    if (method.returnType() != QMetaType::Void) {
+        result = QVariant(method.returnType(), nullptr);
+        returnArgument = QGenericReturnArgument(method.typeName(), result.data());
+    }
+
+    if (!method.invoke(
+                adaptor,
+                Qt::DirectConnection,
+                returnArgument,
+                parameters[0], parameters[1], parameters[2], parameters[3], parameters[4],
+                parameters[5], parameters[6], parameters[7], parameters[8], parameters[9])) {
+        return false;
+    }
+
+    // The slot may have replied already or will reply later.
+    if (message.isReplyRequired() && !message.isDelayedReply()) {
+        connection.send(result.isValid() ? message.createReply(result) : message.createReply());
+    }
+
+    return true;
+}
+
+static QDBusAbstractAdaptor *findAdaptor(QObject *object, const QByteArray &interface)
+{
+    for (QObject * const child : object->children()) {
+        const auto adaptor = qobject_cast<QDBusAbstractAdaptor *>(child);
+        if (adaptor && interface == classInfo(adaptor->metaObject(), "D-Bus Interface")) {
+            return adaptor;
+        }
+    }
+    return nullptr;
+}
+
+static bool readProperty(const QObject *adaptor, const QByteArray &name, QVariant *value)
+{
+    const QMetaObject * const metaObject = adaptor->metaObject();
+    const int index = metaObject->indexOfProperty(name.constData());
+
+    if (index < metaObject->propertyOffset()) {
+        return false;
+    }
+
+    *value = metaObject->property(index).read(adaptor);
+    return value->isValid();
+}
+
+static bool handlePropertiesCall(QObject *object, const QDBusMessage &message, const QDBusConnection &connection)
+{
+    const QVariantList arguments = message.arguments();
+    const QDBusAbstractAdaptor * const adaptor = !arguments.isEmpty()
+            ? findAdaptor(object, arguments.at(0).toString().toUtf8())
+            : nullptr;
+
+    if (!adaptor) {
+        return false;
+    }
+
+    const QMetaObject * const metaObject = adaptor->metaObject();
+    QDBusMessage reply;
+
+    if (message.member() == QLatin1String("Get") && arguments.count() == 2) {
+        QVariant value;
+        if (!readProperty(adaptor, arguments.at(1).toString().toUtf8(), &value)) {
+            reply = message.createErrorReply(QDBusError::UnknownProperty, arguments.at(1).toString());
+        } else {
+            reply = message.createReply(QVariant::fromValue(QDBusVariant(value)));
+        }
+    } else if (message.member() == QLatin1String("GetAll") && arguments.count() == 1) {
+        QVariantMap properties;
+        for (int i = metaObject->propertyOffset(); i < metaObject->propertyCount(); ++i) {
+            const QMetaProperty property = metaObject->property(i);
+            if (property.isReadable()) {
+                properties.insert(QString::fromUtf8(property.name()), property.read(adaptor));
+            }
+        }
+        reply = message.createReply(properties);
+    } else {
+        reply = message.createErrorReply(QDBusError::NotSupported, QString());
+    }
+
+    if (message.isReplyRequired()) {
+        connection.send(reply);
+    }
+
+    return true;
+}
+
+bool dispatchToAdaptor(QObject *object, const QDBusMessage &message, const QDBusConnection &connection)
+{
+    if (message.type() != QDBusMessage::MethodCallMessage) {
+        return false;
+    }
+
+    if (message.interface() == QLatin1String("org.freedesktop.DBus.Properties")) {
+        return handlePropertiesCall(object, message, connection);
+    }
+
+    const QByteArray interface = message.interface().toUtf8();
+    const QByteArray member = message.member().toUtf8();
+    const QByteArray signature = message.signature().toUtf8();
+    bool overloaded = false;
+
+    for (QObject * const child : object->children()) {
+        const auto adaptor = qobject_cast<QDBusAbstractAdaptor *>(child);
+        if (!adaptor) {
+            continue;
+        }
+
+        const QMetaObject * const metaObject = adaptor->metaObject();
+        if (!interface.isEmpty() && interface != classInfo(metaObject, "D-Bus Interface")) {
+            continue;
+        }
+
+        for (int i = metaObject->methodOffset(); i < metaObject->methodCount(); ++i) {
+            const QMetaMethod method = metaObject->method(i);
+
+            if (method.methodType() != QMetaMethod::Slot
+                    || method.access() != QMetaMethod::Public
+                    || method.name() != member) {
+                continue;
+            } else if (inputSignature(method) != signature) {
+                overloaded = true;
+            } else if (invoke(adaptor, method, message, connection)) {
+                return true;
+            }
+        }
+    }
+
+    // The method exists but not with the arguments given.
+    if (overloaded) {
+        if (message.isReplyRequired()) {
+            connection.send(message.createErrorReply(
+                        QDBusError::InvalidArgs,
+                        QStringLiteral("No method %1 with signature '%2'").arg(
+                            message.member(), message.signature())));
+        }
+        return true;
+    }
+
+    return false;
+}
+
+static bool appendArguments(QString *xml, const QMetaMethod &method, const QString &direction)
+{
+    const QList<QByteArray> names = method.parameterNames();
+
+    for (int i = 0; i < method.parameterCount(); ++i) {
+        const char * const type = QDBusMetaType::typeToSignature(method.parameterType(i));
+        if (!type) {
+            return false;
+        }
+        *xml += QStringLiteral("      <arg name=\"%1\" type=\"%2\"%3/>\n").arg(
+                    QString::fromUtf8(names.at(i)), QString::fromLatin1(type), direction);
+    }
+
+    if (method.returnType() != QMetaType::Void) {
+        const char * const type = QDBusMetaType::typeToSignature(method.returnType());
+        if (!type) {
+            return false;
+        }
+        *xml += QStringLiteral("      <arg type=\"%1\" direction=\"out\"/>\n").arg(QString::fromLatin1(type));
+    }
+
+    return true;
+}
+
+// Adaptors which aren't generated by qdbusxml2cpp don't carry their introspection data, describe
+// their properties, public slots and signals instead as Qt would for an object it exports itself.
+static QString generateIntrospection(const QMetaObject *metaObject)
+{
+    QString xml = QStringLiteral("  <interface name=\"%1\">\n").arg(
+                QString::fromUtf8(classInfo(metaObject, "D-Bus Interface")));
+
+    for (int i = metaObject->propertyOffset(); i < metaObject->propertyCount(); ++i) {
+        const QMetaProperty property = metaObject->property(i);
+        const char * const type = QDBusMetaType::typeToSignature(property.userType());
+
+        if (type && property.isReadable()) {
+            xml += QStringLiteral("    <property name=\"%1\" type=\"%2\" access=\"%3\"/>\n").arg(
+                        QString::fromUtf8(property.name()),
+                        QString::fromLatin1(type),
+                        property.isWritable() ? QStringLiteral("readwrite") : QStringLiteral("read"));
+        }
+    }
+
+    for (int i = metaObject->methodOffset(); i < metaObject->methodCount(); ++i) {
+        const QMetaMethod method = metaObject->method(i);
+
+        if (method.access() != QMetaMethod::Public) {
+            continue;
+        } else if (method.methodType() == QMetaMethod::Slot) {
+            QString arguments;
+            if (appendArguments(&arguments, method, QStringLiteral(" direction=\"in\""))) {
+                xml += QStringLiteral("    <method name=\"%1\">\n%2    </method>\n").arg(
+                            QString::fromUtf8(method.name()), arguments);
+            }
+        } else if (method.methodType() == QMetaMethod::Signal) {
+            QString arguments;
+            if (appendArguments(&arguments, method, QString())) {
+                xml += QStringLiteral("    <signal name=\"%1\">\n%2    </signal>\n").arg(
+                            QString::fromUtf8(method.name()), arguments);
+            }
+        }
+    }
+
+    xml += QStringLiteral("  </interface>\n");
+
+    return xml;
+}
+
+QString introspectAdaptors(QObject *object)
+{
+    QString introspection;
+
+    for (QObject * const child : object->children()) {
+        if (const auto adaptor = qobject_cast<QDBusAbstractAdaptor *>(child)) {
+            const char * const xml = classInfo(adaptor->metaObject(), "D-Bus Introspection");
+
+            introspection += xml && *xml
+                    ? QString::fromUtf8(xml)
+                    : generateIntrospection(adaptor->metaObject());
+        }
+    }
+
+    return introspection;
+}
+
+}
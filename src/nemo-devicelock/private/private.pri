@@ -4,7 +4,8 @@ INCLUDEPATH += $$PWD
 PRIVATE_HEADERS += \
         $$PWD/clientauthorization.h \
         $$PWD/connection.h \
-        $$PWD/logging.h
+        $$PWD/logging.h \
+        $$PWD/objectdispatcher.h
 
 HEADERS += \
         $$PWD/settingswatcher.h
@@ -13,5 +14,6 @@ SOURCES += \
         $$PWD/clientauthorization.cpp \
         $$PWD/connection.cpp \
         $$PWD/logging.cpp \
+        $$PWD/objectdispatcher.cpp \
         $$PWD/settingswatcher.cpp
 
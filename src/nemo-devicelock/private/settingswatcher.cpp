@@ -35,11 +35,19 @@
 #include <QDebug>
 #include <QEvent>
 #include <QFile>
+#include <QFileInfo>
 #include <QSettings>
+#include <QThread>
+#include <QVarLengthArray>
+
+#include <atomic>
 
 #include <glib.h>
+#include <fcntl.h>
 #include <sys/inotify.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "logging.h"
@@ -80,7 +88,26 @@ const char * const SettingsWatcher::isHomeEncryptedKey = "encrypt_home";
 
 SettingsWatcher *SettingsWatcher::sharedInstance = nullptr;
 
-SettingsWatcher::SettingsWatcher(QObject *parent)
+static const char * const snapshotName = "settings";
+
+SettingsWatcher::SettingsWatcher(Role role, QObject *parent)
+    : SettingsWatcher(
+          role,
+          QStringLiteral("/usr/share/lipstick/devicelock/devicelock_settings.conf"),
+          QStringLiteral("/run/nemo-devicelock"),
+          QStringLiteral("/var/lib/nemo-devicelock/state"),
+          parent)
+{
+    Q_ASSERT(!sharedInstance);
+    sharedInstance = this;
+}
+
+SettingsWatcher::SettingsWatcher(
+        Role role,
+        const QString &settingsPath,
+        const QString &snapshotDirectory,
+        const QString &statePath,
+        QObject *parent)
     : QSocketNotifier(inotify_init(), Read, parent)
     , automaticLocking(0)
     , currentLength(0)
@@ -100,33 +127,93 @@ SettingsWatcher::SettingsWatcher(QObject *parent)
     , currentCodeIsDigitOnly(true)
     , isHomeEncrypted(false)
     , codeIsMandatory(false)
-    , m_settingsPath(QStringLiteral("/usr/share/lipstick/devicelock/devicelock_settings.conf"))
+    , m_settingsPath(settingsPath)
+    , m_settingsName(QFile::encodeName(QFileInfo(settingsPath).fileName()))
+    , m_snapshotDirectory(QFile::encodeName(snapshotDirectory))
+    , m_snapshotPath(QFile::encodeName(snapshotDirectory + QLatin1Char('/') + QLatin1String(snapshotName)))
+    , m_statePath(statePath)
+    , m_snapshot(nullptr)
+    , m_contentHash(qHash(QByteArray()))
+    , m_snapshotFd(-1)
+    , m_snapshotSequence(0)
     , m_watch(-1)
+    , m_snapshotDirectoryWatch(-1)
+    , m_avoidedReloads(0)
+    , m_publisher(role == Publisher)
 {
-    Q_ASSERT(!sharedInstance);
-    sharedInstance = this;
+    m_reloadTimer.setSingleShot(true);
+    m_reloadTimer.setInterval(20);
+    connect(&m_reloadTimer, &QTimer::timeout, this, &SettingsWatcher::reloadSettings);
+
+    if (!m_publisher && mapSnapshot()) {
+        subscribeToSnapshot();
+    } else {
+        m_watch = inotify_add_watch(
+                    socket(),
+                    QFile::encodeName(QFileInfo(m_settingsPath).path()).constData(),
+                    IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_CLOSE_WRITE | IN_DELETE);
+
+        if (!m_publisher) {
+            // The daemon hasn't published a snapshot yet, read the settings file until it does.
+            m_snapshotDirectoryWatch = inotify_add_watch(
+                        socket(), m_snapshotDirectory.constData(), IN_CREATE | IN_MOVED_TO | IN_ATTRIB);
+        }
+
+        if (m_publisher) {
+            loadState();
+        }
+
+        reloadSettings();
+
+        if (m_publisher) {
+            createSnapshot();
+        }
+    }
+}
 
-    m_watch = inotify_add_watch(
-                socket(),
-                "/usr/share/lipstick/devicelock",
-                IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_CLOSE_WRITE | IN_DELETE);
+void SettingsWatcher::subscribeToSnapshot()
+{
+    // The daemon parses the settings file and publishes the result, all that's needed here
+    // is to be told when it does so.
+    if (m_watch >= 0) {
+        inotify_rm_watch(socket(), m_watch);
+    }
+    if (m_snapshotDirectoryWatch >= 0) {
+        inotify_rm_watch(socket(), m_snapshotDirectoryWatch);
+        m_snapshotDirectoryWatch = -1;
+    }
 
-    reloadSettings();
+    m_watch = inotify_add_watch(socket(), m_snapshotPath.constData(), IN_ATTRIB | IN_MODIFY);
+
+    readSnapshot();
 }
 
 SettingsWatcher::~SettingsWatcher()
 {
     close(socket());
 
-    sharedInstance = nullptr;
+    if (m_snapshot) {
+        munmap(m_snapshot, sizeof(SettingsSnapshot));
+    }
+    if (m_snapshotFd >= 0) {
+        close(m_snapshotFd);
+    }
+
+    if (sharedInstance == this) {
+        sharedInstance = nullptr;
+    }
 }
 
-SettingsWatcher *SettingsWatcher::instance()
+SettingsWatcher *SettingsWatcher::instance(Role role)
 {
-    if (sharedInstance)
+    if (sharedInstance) {
+        if (role == Publisher && !sharedInstance->m_publisher) {
+            qCWarning(devicelock, "Settings were requested for publishing after being subscribed to, they will not be published");
+        }
         return sharedInstance;
+    }
 
-    return sharedInstance ? sharedInstance : new SettingsWatcher;
+    return new SettingsWatcher(role);
 }
 
 bool SettingsWatcher::event(QEvent *event)
@@ -144,10 +231,26 @@ bool SettingsWatcher::event(QEvent *event)
         for (;at < end; at += sizeof(inotify_event) + pevent->len) {
             pevent = reinterpret_cast<inotify_event *>(at);
 
-            if (pevent->wd == m_watch
+            if (pevent->wd == m_snapshotDirectoryWatch
                     && pevent->len > 0
-                    && QLatin1String(pevent->name) == QLatin1String("devicelock_settings.conf")) {
-                reloadSettings();
+                    && qstrcmp(pevent->name, snapshotName) == 0) {
+                // The snapshot is only valid once the daemon has initialized it, which it
+                // signals by touching the file.
+                if (mapSnapshot()) {
+                    subscribeToSnapshot();
+                    return true;
+                }
+            } else if (pevent->wd == m_watch
+                    && ((m_snapshot && !m_publisher)
+                        || (pevent->len > 0
+                            && m_settingsName == pevent->name))) {
+                // A single rewrite of the file produces several events, defer the reload until
+                // they've all arrived and then reload once.
+                if (m_reloadTimer.isActive()) {
+                    ++m_avoidedReloads;
+                } else {
+                    m_reloadTimer.start();
+                }
             }
         }
 
@@ -224,75 +327,405 @@ template <> bool readConfigValue<bool>(
     return value;
 }
 
-template <typename T>
-static void read(
-        GKeyFile *settings,
-        SettingsWatcher *watcher,
-        const char *group,
-        const char *key,
-        T defaultValue,
-        T *member,
-        void (SettingsWatcher::*changed)() = nullptr)
+template <typename T> struct SettingsKey
 {
-    const T value = readConfigValue<T>(settings, group, key, defaultValue);
+    const char *key;
+    T defaultValue;
+    T SettingsWatcher::*member;
+    void (SettingsWatcher::*changed)();
+};
+
+typedef QVarLengthArray<void (SettingsWatcher::*)(), 32> ChangedSignals;
+
+static const SettingsKey<int> integerKeys[] = {
+    { "nemo\\devicelock\\automatic_locking", 0,
+        &SettingsWatcher::automaticLocking, &SettingsWatcher::automaticLockingChanged },
+    { "nemo\\devicelock\\code_current_length", 0,
+        &SettingsWatcher::currentLength, &SettingsWatcher::currentLengthChanged },
+    { "nemo\\devicelock\\code_min_length", 5,
+        &SettingsWatcher::minimumLength, &SettingsWatcher::minimumLengthChanged },
+    { "nemo\\devicelock\\code_max_length", 42,
+        &SettingsWatcher::maximumLength, &SettingsWatcher::maximumLengthChanged },
+    { "nemo\\devicelock\\maximum_attempts", -1,
+        &SettingsWatcher::maximumAttempts, &SettingsWatcher::maximumAttemptsChanged },
+    { "nemo\\devicelock\\peeking_allowed", 1,
+        &SettingsWatcher::peekingAllowed, &SettingsWatcher::peekingAllowedChanged },
+    { "nemo\\devicelock\\sideloading_allowed", -1,
+        &SettingsWatcher::sideloadingAllowed, &SettingsWatcher::sideloadingAllowedChanged },
+    { "nemo\\devicelock\\show_notification", 1,
+        &SettingsWatcher::showNotifications, &SettingsWatcher::showNotificationsChanged },
+    { "nemo\\devicelock\\maximum_automatic_locking", -1,
+        &SettingsWatcher::maximumAutomaticLocking, &SettingsWatcher::maximumAutomaticLockingChanged },
+    { "nemo\\devicelock\\absolute_maximum_attempts", -1,
+        &SettingsWatcher::absoluteMaximumAttempts, &SettingsWatcher::absoluteMaximumAttemptsChanged }
+};
+
+// State which changes with every incorrect security code.  The daemon keeps its own copy in the
+// state file and the plugin's copy in the settings file is only read to seed that.
+static const SettingsKey<int> stateKeys[] = {
+    { "nemo\\devicelock\\current_attempts", 0,
+        &SettingsWatcher::currentAttempts, &SettingsWatcher::currentAttemptsChanged }
+};
+
+static const SettingsKey<bool> booleanKeys[] = {
+    { "nemo\\devicelock\\code_input_is_keyboard", false,
+        &SettingsWatcher::inputIsKeyboard, &SettingsWatcher::inputIsKeyboardChanged },
+    { "nemo\\devicelock\\code_current_is_digit_only", true,
+        &SettingsWatcher::currentCodeIsDigitOnly, &SettingsWatcher::currentCodeIsDigitOnlyChanged },
+    { "nemo\\devicelock\\encrypt_home", false,
+        &SettingsWatcher::isHomeEncrypted, nullptr },
+    { "nemo\\devicelock\\code_is_mandatory", false,
+        &SettingsWatcher::codeIsMandatory, &SettingsWatcher::codeIsMandatoryChanged }
+};
+
+static const SettingsKey<qint64> longKeys[] = {
+    { "nemo\\devicelock\\temporary_lock_timeout", -1,
+        &SettingsWatcher::temporaryLockTimeout, &SettingsWatcher::temporaryLockTimeoutChanged }
+};
+
+static const SettingsKey<DeviceReset::Options> deviceResetKeys[] = {
+    { "nemo\\devicelock\\supported_device_reset_options", DeviceReset::Options(DeviceReset::Reboot),
+        &SettingsWatcher::supportedDeviceResetOptions, &SettingsWatcher::supportedDeviceResetOptionsChanged }
+};
+
+static const SettingsKey<AuthenticationInput::CodeGeneration> codeGenerationKeys[] = {
+    { "nemo\\devicelock\\code_generation", AuthenticationInput::NoCodeGeneration,
+        &SettingsWatcher::codeGeneration, &SettingsWatcher::codeGenerationChanged }
+};
+
+// The plugin rewrites the settings file with each incorrect security code to update its copy of the
+// attempt count, strip that so a rewrite which changes nothing else isn't a change to the settings.
+static QByteArray withoutState(const QByteArray &content)
+{
+    QByteArray settings;
+    settings.reserve(content.size());
+
+    for (int start = 0; start < content.size();) {
+        int end = content.indexOf('\n', start);
+        end = end != -1 ? end + 1 : content.size();
+
+        bool isState = false;
+        for (const SettingsKey<int> &key : stateKeys) {
+            const int length = qstrlen(key.key);
+            isState |= end - start > length
+                    && qstrncmp(content.constData() + start, key.key, length) == 0
+                    && content.at(start + length) == '=';
+        }
 
-    if (*member != value) {
-        *member = value;
-        if (changed) {
-            emit (watcher->*changed)();
+        if (!isState) {
+            settings.append(content.constData() + start, end - start);
         }
+        start = end;
     }
+    return settings;
 }
 
-template <typename T>
+template <typename T, int N>
 static void read(
         GKeyFile *settings,
         SettingsWatcher *watcher,
-        const char *key,
-        T defaultValue,
-        T *member,
-        void (SettingsWatcher::*changed)() = nullptr)
+        const SettingsKey<T> (&keys)[N],
+        ChangedSignals *changed)
 {
-    read(settings,
-                watcher,
-                "desktop",
-                (QByteArrayLiteral("nemo\\devicelock\\") + key).constData(),
-                defaultValue,
-                member,
-                changed);
+    for (const SettingsKey<T> &key : keys) {
+        const T value = readConfigValue<T>(settings, "desktop", key.key, key.defaultValue);
+
+        if (watcher->*key.member != value) {
+            watcher->*key.member = value;
+            if (key.changed) {
+                changed->append(key.changed);
+            }
+        }
+    }
 }
 
 void SettingsWatcher::reloadSettings()
 {
+    qCDebug(devicelock, "Reloading settings, %d reloads avoided by coalescing events", m_avoidedReloads);
+
+    if (m_snapshot && !m_publisher) {
+        readSnapshot();
+        return;
+    }
+
+    QByteArray content;
+
+    QFile file(m_settingsPath);
+    if (file.open(QIODevice::ReadOnly)) {
+        content = withoutState(file.readAll());
+    }
+
+    // Rewriting the file with the same content isn't a change, leave everything as it is.
+    const uint contentHash = qHash(content);
+    if (contentHash == m_contentHash && content == m_content) {
+        return;
+    }
+
+    m_content = content;
+    m_contentHash = contentHash;
+
     GKeyFile * const settings = g_key_file_new();
-    g_key_file_load_from_file(settings, m_settingsPath.toUtf8().constData(), G_KEY_FILE_NONE, 0);
-
-    read(settings, this, automaticLockingKey, 0, &automaticLocking, &SettingsWatcher::automaticLockingChanged);
-    read(settings, this, currentLengthKey, 0, &currentLength, &SettingsWatcher::currentLengthChanged);
-    read(settings, this, minimumLengthKey, 5, &minimumLength, &SettingsWatcher::minimumLengthChanged);
-    read(settings, this, maximumLengthKey, 42, &maximumLength, &SettingsWatcher::maximumLengthChanged);
-    read(settings, this, maximumAttemptsKey, -1, &maximumAttempts, &SettingsWatcher::maximumAttemptsChanged);
-    read(settings, this, currentAttemptsKey, 0, &currentAttempts, &SettingsWatcher::currentAttemptsChanged);
-    read(settings, this, peekingAllowedKey, 1, &peekingAllowed, &SettingsWatcher::peekingAllowedChanged);
-    read(settings, this, sideloadingAllowedKey, -1, &sideloadingAllowed, &SettingsWatcher::sideloadingAllowedChanged);
-    read(settings, this, showNotificationsKey, 1, &showNotifications, &SettingsWatcher::showNotificationsChanged);
-    read(settings, this, inputIsKeyboardKey, false, &inputIsKeyboard, &SettingsWatcher::inputIsKeyboardChanged);
-    read(settings, this, currentIsDigitOnlyKey, true, &currentCodeIsDigitOnly, &SettingsWatcher::currentCodeIsDigitOnlyChanged);
-    read(settings, this, isHomeEncryptedKey, false, &isHomeEncrypted);
-
-    read(settings, this, "maximum_automatic_locking", -1, &maximumAutomaticLocking,
-         &SettingsWatcher::maximumAutomaticLockingChanged);
-    read(settings, this, "absolute_maximum_attempts", -1, &absoluteMaximumAttempts,
-         &SettingsWatcher::absoluteMaximumAttemptsChanged);
-    read(settings, this, "supported_device_reset_options", DeviceReset::Options(DeviceReset::Reboot),
-         &supportedDeviceResetOptions, &SettingsWatcher::supportedDeviceResetOptionsChanged);
-    read(settings, this, "code_is_mandatory", false, &codeIsMandatory, &SettingsWatcher::codeIsMandatoryChanged);
-    read(settings, this, "code_generation", AuthenticationInput::NoCodeGeneration,
-         &codeGeneration, &SettingsWatcher::codeGenerationChanged);
-    read(settings, this, "temporary_lock_timeout", static_cast<qint64>(-1), &temporaryLockTimeout,
-         &SettingsWatcher::temporaryLockTimeoutChanged);
+    g_key_file_load_from_data(settings, content.constData(), content.size(), G_KEY_FILE_NONE, 0);
+
+    ChangedSignals changed;
+
+    read(settings, this, integerKeys, &changed);
+    read(settings, this, booleanKeys, &changed);
+    read(settings, this, longKeys, &changed);
+    read(settings, this, deviceResetKeys, &changed);
+    read(settings, this, codeGenerationKeys, &changed);
 
     g_key_file_free(settings);
+
+    if (m_snapshot) {
+        publishSnapshot();
+    }
+
+    // Signal changes only once every value has been updated so that handlers never observe a
+    // partially updated configuration.
+    for (const auto signal : changed) {
+        emit (this->*signal)();
+    }
+}
+
+/*
+    The snapshot holds the values of each key table in table order.  The layout version must be
+    incremented whenever the tables or the layout change.
+*/
+struct SettingsValues
+{
+    qint64 longs[sizeof(longKeys) / sizeof(longKeys[0])];
+    qint32 integers[sizeof(integerKeys) / sizeof(integerKeys[0])];
+    qint32 deviceResetOptions[sizeof(deviceResetKeys) / sizeof(deviceResetKeys[0])];
+    qint32 codeGenerations[sizeof(codeGenerationKeys) / sizeof(codeGenerationKeys[0])];
+    quint8 booleans[sizeof(booleanKeys) / sizeof(booleanKeys[0])];
+};
+
+struct SettingsSnapshot
+{
+    enum {
+        Magic = 0x4e444c53, // NDLS
+        Version = 2
+    };
+
+    quint32 magic;
+    quint32 version;
+    quint32 size;
+    // Odd while the values are being written, incremented again once they're complete.
+    QAtomicInteger<quint32> sequence;
+    SettingsValues values;
+};
+
+template <typename T, typename V, int N>
+static void storeValues(const SettingsWatcher *watcher, const SettingsKey<T> (&keys)[N], V (&values)[N])
+{
+    for (int i = 0; i < N; ++i) {
+        values[i] = V(watcher->*keys[i].member);
+    }
+}
+
+template <typename T, typename V, int N>
+static void loadValues(
+        SettingsWatcher *watcher,
+        const SettingsKey<T> (&keys)[N],
+        const V (&values)[N],
+        ChangedSignals *changed)
+{
+    for (int i = 0; i < N; ++i) {
+        const T value = T(values[i]);
+
+        if (watcher->*keys[i].member != value) {
+            watcher->*keys[i].member = value;
+            if (keys[i].changed) {
+                changed->append(keys[i].changed);
+            }
+        }
+    }
+}
+
+static bool isValidSnapshot(const SettingsSnapshot *snapshot)
+{
+    return snapshot->magic == SettingsSnapshot::Magic
+            && snapshot->version == SettingsSnapshot::Version
+            && snapshot->size == sizeof(SettingsSnapshot);
+}
+
+bool SettingsWatcher::mapSnapshot()
+{
+    const int fd = open(m_snapshotPath.constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat status;
+    void *memory = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && status.st_size >= off_t(sizeof(SettingsSnapshot))) {
+        memory = mmap(nullptr, sizeof(SettingsSnapshot), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (memory == MAP_FAILED) {
+        return false;
+    } else if (!isValidSnapshot(static_cast<SettingsSnapshot *>(memory))) {
+        munmap(memory, sizeof(SettingsSnapshot));
+        return false;
+    }
+
+    m_snapshot = static_cast<SettingsSnapshot *>(memory);
+
+    return true;
+}
+
+void SettingsWatcher::createSnapshot()
+{
+    int fd = open(m_snapshotPath.constData(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+    struct stat status;
+    if (fd >= 0 && fstat(fd, &status) == 0 && status.st_size != 0
+            && status.st_size != off_t(sizeof(SettingsSnapshot))) {
+        // A snapshot with a different layout may still be mapped by clients of an older version,
+        // replace it rather than change it under them.
+        close(fd);
+        unlink(m_snapshotPath.constData());
+        fd = open(m_snapshotPath.constData(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    }
+
+    if (fd < 0 || fchmod(fd, 0644) != 0 || ftruncate(fd, sizeof(SettingsSnapshot)) != 0) {
+        qCWarning(devicelock, "Failed to create the settings snapshot %s", m_snapshotPath.constData());
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+
+    void * const memory = mmap(nullptr, sizeof(SettingsSnapshot), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED) {
+        qCWarning(devicelock, "Failed to map the settings snapshot %s", m_snapshotPath.constData());
+        close(fd);
+        return;
+    }
+
+    m_snapshot = static_cast<SettingsSnapshot *>(memory);
+    m_snapshotFd = fd;
+
+    // Keep counting from the sequence of a previous instance so clients which are already mapped
+    // don't mistake new values for ones they've already read. An odd sequence means a previous
+    // instance was interrupted part way through an update.
+    const quint32 sequence = isValidSnapshot(m_snapshot) ? m_snapshot->sequence.load() : 0;
+
+    m_snapshot->sequence.store(sequence + (sequence & 1));
+    m_snapshot->magic = SettingsSnapshot::Magic;
+    m_snapshot->version = SettingsSnapshot::Version;
+    m_snapshot->size = sizeof(SettingsSnapshot);
+
+    publishSnapshot();
+}
+
+void SettingsWatcher::loadState()
+{
+    QSettings state(m_statePath, QSettings::IniFormat);
+
+    bool ok = false;
+    const int attempts = state.value(QStringLiteral("DeviceLock/currentAttempts")).toInt(&ok);
+    if (ok) {
+        currentAttempts = attempts;
+        return;
+    }
+
+    // There's no state yet, carry on from the count last written by the plugin.
+    GKeyFile * const settings = g_key_file_new();
+    if (g_key_file_load_from_file(settings, QFile::encodeName(m_settingsPath).constData(), G_KEY_FILE_NONE, 0)) {
+        ChangedSignals changed;
+        read(settings, this, stateKeys, &changed);
+    }
+    g_key_file_free(settings);
+
+    state.setValue(QStringLiteral("DeviceLock/currentAttempts"), currentAttempts);
+}
+
+void SettingsWatcher::setCurrentAttempts(int attempts)
+{
+    if (currentAttempts != attempts) {
+        currentAttempts = attempts;
+
+        QSettings state(m_statePath, QSettings::IniFormat);
+        state.setValue(QStringLiteral("DeviceLock/currentAttempts"), attempts);
+
+        emit currentAttemptsChanged();
+    }
+}
+
+void SettingsWatcher::publishSnapshot()
+{
+    SettingsValues values;
+    memset(&values, 0, sizeof(SettingsValues));
+
+    storeValues(this, longKeys, values.longs);
+    storeValues(this, integerKeys, values.integers);
+    storeValues(this, deviceResetKeys, values.deviceResetOptions);
+    storeValues(this, codeGenerationKeys, values.codeGenerations);
+    storeValues(this, booleanKeys, values.booleans);
+
+    const quint32 sequence = m_snapshot->sequence.load();
+
+    // Changes to daemon state alone leave the snapshot as it is, don't wake clients for them.
+    if (sequence != 0 && memcmp(&m_snapshot->values, &values, sizeof(SettingsValues)) == 0) {
+        return;
+    }
+
+    m_snapshot->sequence.store(sequence + 1);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&m_snapshot->values, &values, sizeof(SettingsValues));
+    m_snapshot->sequence.storeRelease(sequence + 2);
+
+    // Writes to the mapping don't generate inotify events, touch the file to notify clients.
+    futimens(m_snapshotFd, nullptr);
+}
+
+void SettingsWatcher::readSnapshot()
+{
+    SettingsValues values;
+
+    // Retry if the values were changed while they were being copied. If the daemon never
+    // completes the update the current values are kept until it notifies of another.
+    for (int attempt = 0;; ++attempt) {
+        if (attempt == 100) {
+            qCWarning(devicelock, "Failed to read a consistent settings snapshot");
+            return;
+        }
+
+        if (attempt > 0) {
+            // Give the daemon a chance to complete the update.
+            QThread::yieldCurrentThread();
+        }
+
+        const quint32 sequence = m_snapshot->sequence.loadAcquire();
+        if (sequence & 1) {
+            continue;
+        } else if (sequence == m_snapshotSequence) {
+            return;
+        }
+
+        memcpy(&values, &m_snapshot->values, sizeof(SettingsValues));
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (m_snapshot->sequence.load() == sequence) {
+            m_snapshotSequence = sequence;
+            break;
+        }
+    }
+
+    ChangedSignals changed;
+
+    loadValues(this, longKeys, values.longs, &changed);
+    loadValues(this, integerKeys, values.integers, &changed);
+    loadValues(this, deviceResetKeys, values.deviceResetOptions, &changed);
+    loadValues(this, codeGenerationKeys, values.codeGenerations, &changed);
+    loadValues(this, booleanKeys, values.booleans, &changed);
+
+    for (const auto signal : changed) {
+        emit (this->*signal)();
+    }
 }
 
 }
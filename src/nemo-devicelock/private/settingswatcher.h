@@ -39,6 +39,7 @@
 #include <QMetaEnum>
 #include <QSharedData>
 #include <QSocketNotifier>
+#include <QTimer>
 
 namespace NemoDeviceLock
 {
@@ -62,13 +63,27 @@ template <> inline QMetaEnum resolveMetaEnum<AuthenticationInput::CodeGeneration
 template <> inline AuthenticationInput::CodeGeneration settingsValueFromString<AuthenticationInput::CodeGeneration>(const char *string) {
     return AuthenticationInput::CodeGeneration(flagsFromString(resolveMetaEnum<AuthenticationInput::CodeGeneration>(), string)); }
 
+struct SettingsSnapshot;
 class NEMODEVICELOCK_EXPORT SettingsWatcher : public QSocketNotifier, public QSharedData
 {
     Q_OBJECT
 public:
+    enum Role {
+        Subscriber,
+        Publisher
+    };
+
+    // A watcher of settings stored somewhere other than the system locations, it isn't shared
+    // with instance().
+    SettingsWatcher(
+            Role role,
+            const QString &settingsPath,
+            const QString &snapshotDirectory,
+            const QString &statePath,
+            QObject *parent = nullptr);
     ~SettingsWatcher();
 
-    static SettingsWatcher *instance();
+    static SettingsWatcher *instance(Role role = Subscriber);
 
     int automaticLocking;
     int currentLength;
@@ -102,6 +117,8 @@ public:
     static const char * const currentIsDigitOnlyKey;
     static const char * const isHomeEncryptedKey;
 
+    void setCurrentAttempts(int attempts);
+
     bool event(QEvent *event);
 
 signals:
@@ -123,13 +140,35 @@ signals:
     void codeGenerationChanged();
     void temporaryLockTimeoutChanged();
 
-private:
-    explicit SettingsWatcher(QObject *parent = nullptr);
-
+private slots:
     void reloadSettings();
 
-    QString m_settingsPath;
+private:
+    explicit SettingsWatcher(Role role, QObject *parent = nullptr);
+
+    void loadState();
+
+    bool mapSnapshot();
+    void subscribeToSnapshot();
+    void createSnapshot();
+    void publishSnapshot();
+    void readSnapshot();
+
+    const QString m_settingsPath;
+    const QByteArray m_settingsName;
+    const QByteArray m_snapshotDirectory;
+    const QByteArray m_snapshotPath;
+    const QString m_statePath;
+    QByteArray m_content;
+    QTimer m_reloadTimer;
+    SettingsSnapshot *m_snapshot;
+    uint m_contentHash;
+    int m_snapshotFd;
+    quint32 m_snapshotSequence;
     int m_watch;
+    int m_snapshotDirectoryWatch;
+    int m_avoidedReloads;
+    const bool m_publisher;
 
     static SettingsWatcher *sharedInstance;
 };
@@ -0,0 +1,15 @@
+PKGCONFIG += \
+        dbus-1 \
+        keepalive \
+        libsystemd
+
+INCLUDEPATH += \
+        $$PWD/../src/nemo-devicelock/host \
+        $$PWD/../src/nemo-devicelock/host/cli
+
+PRE_TARGETDEPS += \
+        $$OUT_PWD/../../src/nemo-devicelock/host/libnemodevicelock-host.a
+
+LIBS += -L$$OUT_PWD/../../src/nemo-devicelock/host -lnemodevicelock-host
+
+include($$PWD/tests.pri)
@@ -0,0 +1,21 @@
+TEMPLATE = app
+
+QT -= gui
+QT += dbus testlib
+
+CONFIG += \
+        link_pkgconfig
+
+PKGCONFIG += \
+        glib-2.0 \
+        nemodbus
+
+INCLUDEPATH += \
+        $$PWD/../src \
+        $$PWD/../src/nemo-devicelock/private
+
+LIBS += -L$$OUT_PWD/../../src/nemo-devicelock -lnemodevicelock
+
+target.path = /opt/tests/nemo-qml-plugin-devicelock
+
+INSTALLS += target
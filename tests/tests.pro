@@ -0,0 +1,15 @@
+TEMPLATE = subdirs
+
+SUBDIRS = \
+        ut_admissionlimiter \
+        ut_objectdispatcher \
+        ut_pluginworker \
+        ut_settingswatcher
+
+OTHER_FILES += \
+        tests.xml
+
+tests_xml.files = tests.xml
+tests_xml.path = /opt/tests/nemo-qml-plugin-devicelock
+
+INSTALLS += tests_xml
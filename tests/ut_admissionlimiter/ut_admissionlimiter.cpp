@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "admissionlimiter.h"
+
+#include <QtTest>
+
+using namespace NemoDeviceLock;
+
+class ut_admissionlimiter : public QObject
+{
+    Q_OBJECT
+private slots:
+    void burst();
+    void accrual();
+    void cap();
+};
+
+void ut_admissionlimiter::burst()
+{
+    AdmissionLimiter limiter(20, 10);
+
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(limiter.admit(0));
+    }
+
+    QVERIFY(!limiter.admit(0));
+    QCOMPARE(limiter.delay(), 50);
+}
+
+void ut_admissionlimiter::accrual()
+{
+    AdmissionLimiter limiter(20, 1);
+
+    QVERIFY(limiter.admit(0));
+    QVERIFY(!limiter.admit(0));
+
+    // Credit accrues by the millisecond, a connection is admitted once a whole one has.
+    QVERIFY(!limiter.admit(49));
+    QCOMPARE(limiter.delay(), 1);
+    QVERIFY(limiter.admit(1));
+    QVERIFY(!limiter.admit(0));
+    QCOMPARE(limiter.delay(), 50);
+}
+
+void ut_admissionlimiter::cap()
+{
+    AdmissionLimiter limiter(20, 3);
+
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(limiter.admit(0));
+    }
+
+    // A long idle period doesn't allow more than a burst of connections.
+    QVERIFY(limiter.admit(3600 * 1000));
+    QVERIFY(limiter.admit(0));
+    QVERIFY(limiter.admit(0));
+    QVERIFY(!limiter.admit(0));
+    QCOMPARE(limiter.delay(), 50);
+}
+
+QTEST_GUILESS_MAIN(ut_admissionlimiter)
+
+#include "ut_admissionlimiter.moc"
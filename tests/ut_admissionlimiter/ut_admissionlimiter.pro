@@ -0,0 +1,6 @@
+TARGET = ut_admissionlimiter
+
+include(../host.pri)
+
+SOURCES = \
+        ut_admissionlimiter.cpp
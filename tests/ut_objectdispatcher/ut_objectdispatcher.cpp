@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "objectdispatcher.h"
+
+#include <QDBusAbstractAdaptor>
+#include <QDBusPendingCall>
+#include <QDBusPendingReply>
+#include <QDBusServer>
+#include <QDBusVariant>
+#include <QDBusVirtualObject>
+#include <QtTest>
+
+using namespace NemoDeviceLock;
+
+class TestAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.nemomobile.devicelock.Test")
+    Q_PROPERTY(int Value READ value)
+    Q_PROPERTY(QString Name READ name)
+public:
+    explicit TestAdaptor(QObject *parent) : QDBusAbstractAdaptor(parent) {}
+
+    int value() const { return 42; }
+    QString name() const { return m_name; }
+
+    QString m_name;
+
+public slots:
+    int Add(int first, int second) { return first + second; }
+    void SetName(const QString &name) { m_name = name; emit NameChanged(name); }
+
+signals:
+    void NameChanged(const QString &name);
+};
+
+class TestObjects : public QDBusVirtualObject
+{
+public:
+    explicit TestObjects(QObject *object) : m_object(object) {}
+
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override
+    {
+        return dispatchToAdaptor(m_object, message, connection);
+    }
+
+    QString introspect(const QString &) const override
+    {
+        return introspectAdaptors(m_object);
+    }
+
+private:
+    QObject * const m_object;
+};
+
+class ut_objectdispatcher : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void callWithResult();
+    void callWithoutResult();
+    void invalidArguments();
+    void unknownMethod();
+    void getProperty();
+    void getAllProperties();
+    void introspect();
+
+private:
+    QDBusMessage callObject(const QString &interface, const QString &method, const QVariantList &arguments);
+
+    QObject m_object;
+    TestAdaptor *m_adaptor = nullptr;
+    QScopedPointer<TestObjects> m_objects;
+    QScopedPointer<QDBusServer> m_server;
+    QString m_serverConnection;
+};
+
+void ut_objectdispatcher::initTestCase()
+{
+    m_adaptor = new TestAdaptor(&m_object);
+    m_objects.reset(new TestObjects(&m_object));
+
+    m_server.reset(new QDBusServer(QStringLiteral("unix:tmpdir=/tmp")));
+    m_server->setAnonymousAuthenticationAllowed(true);
+    QVERIFY(m_server->isConnected());
+
+    connect(m_server.data(), &QDBusServer::newConnection, this, [this](const QDBusConnection &connection) {
+        m_serverConnection = connection.name();
+        QDBusConnection(connection).registerVirtualObject(QStringLiteral("/test"), m_objects.data());
+    });
+
+    QVERIFY(QDBusConnection::connectToPeer(m_server->address(), QStringLiteral("client")).isConnected());
+    QTRY_VERIFY(!m_serverConnection.isEmpty());
+}
+
+void ut_objectdispatcher::cleanupTestCase()
+{
+    QDBusConnection::disconnectFromPeer(QStringLiteral("client"));
+    QDBusConnection::disconnectFromPeer(m_serverConnection);
+}
+
+QDBusMessage ut_objectdispatcher::callObject(
+        const QString &interface, const QString &method, const QVariantList &arguments)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(QString(), QStringLiteral("/test"), interface, method);
+    message.setArguments(arguments);
+
+    // Both ends of the connection are in this process, keep the event loop running until the
+    // reply arrives.
+    QDBusPendingCall call = QDBusConnection(QStringLiteral("client")).asyncCall(message);
+    for (int i = 0; i < 500 && !call.isFinished(); ++i) {
+        QTest::qWait(10);
+    }
+
+    return call.reply();
+}
+
+void ut_objectdispatcher::callWithResult()
+{
+    const QDBusMessage reply = callObject(
+                QStringLiteral("org.nemomobile.devicelock.Test"), QStringLiteral("Add"), QVariantList() << 2 << 3);
+
+    QCOMPARE(reply.type(), QDBusMessage::ReplyMessage);
+    QCOMPARE(reply.arguments(), QVariantList() << 5);
+}
+
+void ut_objectdispatcher::callWithoutResult()
+{
+    const QDBusMessage reply = callObject(
+                QString(), QStringLiteral("SetName"), QVariantList() << QStringLiteral("lock"));
+
+    QCOMPARE(reply.type(), QDBusMessage::ReplyMessage);
+    QCOMPARE(reply.arguments(), QVariantList());
+    QCOMPARE(m_adaptor->m_name, QStringLiteral("lock"));
+}
+
+void ut_objectdispatcher::invalidArguments()
+{
+    const QDBusMessage reply = callObject(
+                QStringLiteral("org.nemomobile.devicelock.Test"),
+                QStringLiteral("Add"),
+                QVariantList() << QStringLiteral("2") << 3);
+
+    QCOMPARE(reply.type(), QDBusMessage::ErrorMessage);
+    QCOMPARE(QDBusError(reply).type(), QDBusError::InvalidArgs);
+}
+
+void ut_objectdispatcher::unknownMethod()
+{
+    const QDBusMessage reply = callObject(
+                QStringLiteral("org.nemomobile.devicelock.Test"), QStringLiteral("Subtract"), QVariantList() << 2 << 3);
+
+    QCOMPARE(reply.type(), QDBusMessage::ErrorMessage);
+}
+
+void ut_objectdispatcher::getProperty()
+{
+    const QDBusMessage reply = callObject(
+                QStringLiteral("org.freedesktop.DBus.Properties"),
+                QStringLiteral("Get"),
+                QVariantList() << QStringLiteral("org.nemomobile.devicelock.Test") << QStringLiteral("Value"));
+
+    QCOMPARE(reply.type(), QDBusMessage::ReplyMessage);
+    QCOMPARE(reply.arguments().count(), 1);
+    QCOMPARE(qvariant_cast<QDBusVariant>(reply.arguments().at(0)).variant(), QVariant(42));
+
+    const QDBusMessage error = callObject(
+                QStringLiteral("org.freedesktop.DBus.Properties"),
+                QStringLiteral("Get"),
+                QVariantList() << QStringLiteral("org.nemomobile.devicelock.Test") << QStringLiteral("Missing"));
+
+    QCOMPARE(error.type(), QDBusMessage::ErrorMessage);
+    QCOMPARE(QDBusError(error).type(), QDBusError::UnknownProperty);
+}
+
+void ut_objectdispatcher::getAllProperties()
+{
+    m_adaptor->m_name = QStringLiteral("device");
+
+    const QDBusMessage reply = callObject(
+                QStringLiteral("org.freedesktop.DBus.Properties"),
+                QStringLiteral("GetAll"),
+                QVariantList() << QStringLiteral("org.nemomobile.devicelock.Test"));
+
+    QCOMPARE(reply.type(), QDBusMessage::ReplyMessage);
+
+    const QDBusPendingReply<QVariantMap> properties(reply);
+    QCOMPARE(properties.value().value(QStringLiteral("Value")), QVariant(42));
+    QCOMPARE(properties.value().value(QStringLiteral("Name")), QVariant(QStringLiteral("device")));
+}
+
+void ut_objectdispatcher::introspect()
+{
+    const QString xml = introspectAdaptors(&m_object);
+
+    QVERIFY(xml.contains(QStringLiteral("<interface name=\"org.nemomobile.devicelock.Test\">")));
+    QVERIFY(xml.contains(QStringLiteral("<property name=\"Value\" type=\"i\" access=\"read\"/>")));
+    QVERIFY(xml.contains(QStringLiteral("<method name=\"Add\">")));
+    QVERIFY(xml.contains(QStringLiteral("<arg name=\"first\" type=\"i\" direction=\"in\"/>")));
+    QVERIFY(xml.contains(QStringLiteral("<arg type=\"i\" direction=\"out\"/>")));
+    QVERIFY(xml.contains(QStringLiteral("<signal name=\"NameChanged\">")));
+}
+
+QTEST_GUILESS_MAIN(ut_objectdispatcher)
+
+#include "ut_objectdispatcher.moc"
@@ -0,0 +1,6 @@
+TARGET = ut_objectdispatcher
+
+include(../tests.pri)
+
+SOURCES = \
+        ut_objectdispatcher.cpp
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "pluginworker.h"
+
+#include <nemo-devicelock/host/hostauthenticationinput.h>
+
+#include <QThread>
+#include <QtEndian>
+#include <QtTest>
+
+#include <unistd.h>
+
+using namespace NemoDeviceLock;
+
+static bool readFully(void *data, size_t size)
+{
+    char *at = static_cast<char *>(data);
+    while (size > 0) {
+        const ssize_t count = ::read(STDIN_FILENO, at, size);
+        if (count <= 0) {
+            return false;
+        }
+        at += count;
+        size -= count;
+    }
+    return true;
+}
+
+static bool readInteger(quint32 *value)
+{
+    uchar bytes[sizeof(quint32)];
+    if (!readFully(bytes, sizeof(bytes))) {
+        return false;
+    }
+    *value = qFromBigEndian<quint32>(bytes);
+    return true;
+}
+
+// A stand in for the lock code plugin, the test executable runs as it when started with the
+// --worker argument.  Each request is answered with an exit code derived from its arguments.
+static int runWorker()
+{
+    for (;;) {
+        quint32 count = 0;
+        if (!readInteger(&count)) {
+            return 0;
+        }
+
+        QStringList arguments;
+        for (quint32 i = 0; i < count; ++i) {
+            quint32 length = 0;
+            if (!readInteger(&length)) {
+                return 1;
+            }
+            QByteArray argument(int(length), '\0');
+            if (!readFully(argument.data(), length)) {
+                return 1;
+            }
+            arguments.append(QString::fromUtf8(argument));
+        }
+
+        const QString command = arguments.value(0);
+        qint32 exitCode = 0;
+
+        if (command == QLatin1String("--exit")) {
+            return 0;
+        } else if (command == QLatin1String("--reply")) {
+            exitCode = arguments.value(1).toInt();
+        } else if (command == QLatin1String("--count")) {
+            exitCode = arguments.count() - 1;
+        } else if (command == QLatin1String("--length")) {
+            exitCode = arguments.value(1).toUtf8().size();
+        } else if (command == QLatin1String("--delay")) {
+            QThread::msleep(arguments.value(1).toUInt());
+            exitCode = arguments.value(2).toInt();
+        }
+
+        uchar reply[sizeof(qint32)];
+        qToBigEndian<qint32>(exitCode, reply);
+        if (::write(STDOUT_FILENO, reply, sizeof(reply)) != sizeof(reply)) {
+            return 1;
+        }
+    }
+}
+
+class ut_pluginworker : public QObject
+{
+    Q_OBJECT
+private slots:
+    void synchronousCall();
+    void argumentFraming();
+    void pipelinedCalls();
+    void repliesHeldDuringSynchronousCall();
+    void workerExit();
+    void contextDestroyed();
+};
+
+void ut_pluginworker::synchronousCall()
+{
+    PluginWorker worker(QCoreApplication::applicationFilePath());
+
+    int result = 0;
+    QVERIFY(worker.call(QStringList() << QStringLiteral("--reply") << QStringLiteral("3"), &result));
+    QCOMPARE(result, -3);
+
+    QVERIFY(worker.call(QStringList() << QStringLiteral("--reply") << QStringLiteral("0"), &result));
+    QCOMPARE(result, 0);
+}
+
+void ut_pluginworker::argumentFraming()
+{
+    PluginWorker worker(QCoreApplication::applicationFilePath());
+
+    int result = 0;
+    QVERIFY(worker.call(QStringList()
+                << QStringLiteral("--count")
+                << QStringLiteral("a")
+                << QString()
+                << QStringLiteral("c"), &result));
+    QCOMPARE(result, -3);
+
+    // Lengths are of the UTF-8 encoding, not of the string.
+    QVERIFY(worker.call(QStringList() << QStringLiteral("--length") << QString::fromUtf8("\xc3\xa4\xe2\x82\xac"), &result));
+    QCOMPARE(result, -5);
+}
+
+void ut_pluginworker::pipelinedCalls()
+{
+    PluginWorker worker(QCoreApplication::applicationFilePath());
+    QVERIFY(worker.start());
+
+    QList<int> results;
+    for (int i = 1; i <= 3; ++i) {
+        worker.call(QStringList() << QStringLiteral("--reply") << QString::number(i), this, [&results](int result) {
+            results.append(result);
+        });
+    }
+
+    QTRY_COMPARE(results, QList<int>() << -1 << -2 << -3);
+}
+
+void ut_pluginworker::repliesHeldDuringSynchronousCall()
+{
+    PluginWorker worker(QCoreApplication::applicationFilePath());
+    QVERIFY(worker.start());
+
+    QList<int> results;
+    worker.call(QStringList() << QStringLiteral("--reply") << QStringLiteral("1"), this, [&results](int result) {
+        results.append(result);
+    });
+
+    int result = 0;
+    QVERIFY(worker.call(QStringList() << QStringLiteral("--delay") << QStringLiteral("50") << QStringLiteral("2"), &result));
+    QCOMPARE(result, -2);
+
+    // The earlier reply arrived during the synchronous call but is only delivered after it.
+    QVERIFY(results.isEmpty());
+    QTRY_COMPARE(results, QList<int>() << -1);
+}
+
+void ut_pluginworker::workerExit()
+{
+    PluginWorker worker(QCoreApplication::applicationFilePath());
+
+    // A request which was sent is failed rather than repeated if the worker exits.
+    int result = 0;
+    QVERIFY(worker.call(QStringList() << QStringLiteral("--exit"), &result));
+    QCOMPARE(result, int(HostAuthenticationInput::Failure));
+
+    // The worker is restarted for the next request.
+    QVERIFY(worker.call(QStringList() << QStringLiteral("--reply") << QStringLiteral("4"), &result));
+    QCOMPARE(result, -4);
+}
+
+void ut_pluginworker::contextDestroyed()
+{
+    PluginWorker worker(QCoreApplication::applicationFilePath());
+    QVERIFY(worker.start());
+
+    bool called = false;
+    QScopedPointer<QObject> context(new QObject);
+    worker.call(QStringList() << QStringLiteral("--reply") << QStringLiteral("1"), context.data(), [&called](int) {
+        called = true;
+    });
+    context.reset();
+
+    // A later call is answered after the first so once it has been the first has been handled.
+    int result = 0;
+    QVERIFY(worker.call(QStringList() << QStringLiteral("--reply") << QStringLiteral("2"), &result));
+    QCOMPARE(result, -2);
+    QTest::qWait(0);
+
+    QVERIFY(!called);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && qstrcmp(argv[1], "--worker") == 0) {
+        return runWorker();
+    }
+
+    QCoreApplication application(argc, argv);
+    ut_pluginworker test;
+
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "ut_pluginworker.moc"
@@ -0,0 +1,6 @@
+TARGET = ut_pluginworker
+
+include(../host.pri)
+
+SOURCES = \
+        ut_pluginworker.cpp
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2026 Open Mobile Platform LLC
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Nemo Mobile nor the names of its contributors
+ *     may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include "settingswatcher.h"
+
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <stdio.h>
+
+using namespace NemoDeviceLock;
+
+class ut_settingswatcher : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void publisherReadsSettings();
+    void subscriberReadsSnapshot();
+    void subscriberFollowsPublisher();
+    void attemptRewriteIgnored();
+    void invalidSnapshotIgnored();
+    void attemptsPersisted();
+
+private:
+    void writeSettings(int automaticLocking, int currentAttempts);
+    SettingsWatcher *createWatcher(SettingsWatcher::Role role);
+
+    QScopedPointer<QTemporaryDir> m_directory;
+    QString m_settingsPath;
+    QString m_snapshotDirectory;
+    QString m_statePath;
+};
+
+void ut_settingswatcher::init()
+{
+    m_directory.reset(new QTemporaryDir);
+    QVERIFY(m_directory->isValid());
+
+    m_settingsPath = m_directory->path() + QStringLiteral("/devicelock_settings.conf");
+    m_snapshotDirectory = m_directory->path() + QStringLiteral("/run");
+    m_statePath = m_directory->path() + QStringLiteral("/state");
+
+    QVERIFY(QDir(m_directory->path()).mkdir(QStringLiteral("run")));
+
+    writeSettings(5, 2);
+}
+
+void ut_settingswatcher::cleanup()
+{
+    m_directory.reset();
+}
+
+void ut_settingswatcher::writeSettings(int automaticLocking, int currentAttempts)
+{
+    // Replace the file the way the plugin does, by renaming a new file over it.
+    const QString temporaryPath = m_settingsPath + QStringLiteral(".new");
+
+    QFile file(temporaryPath);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("[desktop]\n");
+    file.write("nemo\\devicelock\\automatic_locking=" + QByteArray::number(automaticLocking) + "\n");
+    file.write("nemo\\devicelock\\code_min_length=4\n");
+    file.write("nemo\\devicelock\\maximum_attempts=3\n");
+    file.write("nemo\\devicelock\\current_attempts=" + QByteArray::number(currentAttempts) + "\n");
+    file.write("nemo\\devicelock\\code_input_is_keyboard=true\n");
+    file.close();
+
+    QVERIFY(::rename(QFile::encodeName(temporaryPath).constData(), QFile::encodeName(m_settingsPath).constData()) == 0);
+}
+
+SettingsWatcher *ut_settingswatcher::createWatcher(SettingsWatcher::Role role)
+{
+    return new SettingsWatcher(role, m_settingsPath, m_snapshotDirectory, m_statePath);
+}
+
+void ut_settingswatcher::publisherReadsSettings()
+{
+    QScopedPointer<SettingsWatcher> publisher(createWatcher(SettingsWatcher::Publisher));
+
+    QCOMPARE(publisher->automaticLocking, 5);
+    QCOMPARE(publisher->minimumLength, 4);
+    QCOMPARE(publisher->maximumLength, 42);
+    QCOMPARE(publisher->maximumAttempts, 3);
+    QCOMPARE(publisher->inputIsKeyboard, true);
+
+    // Without any saved state the attempt count is carried on from the settings file.
+    QCOMPARE(publisher->currentAttempts, 2);
+
+    QVERIFY(QFile::exists(m_snapshotDirectory + QStringLiteral("/settings")));
+    QVERIFY(QFile::exists(m_statePath));
+}
+
+void ut_settingswatcher::subscriberReadsSnapshot()
+{
+    QScopedPointer<SettingsWatcher> publisher(createWatcher(SettingsWatcher::Publisher));
+
+    // The publisher doesn't see this change until the event loop runs, a subscriber which reads
+    // the snapshot rather than the file has the values the publisher read.
+    writeSettings(10, 2);
+
+    QScopedPointer<SettingsWatcher> subscriber(createWatcher(SettingsWatcher::Subscriber));
+
+    QCOMPARE(subscriber->automaticLocking, 5);
+    QCOMPARE(subscriber->minimumLength, 4);
+    QCOMPARE(subscriber->maximumAttempts, 3);
+    QCOMPARE(subscriber->inputIsKeyboard, true);
+}
+
+void ut_settingswatcher::subscriberFollowsPublisher()
+{
+    QScopedPointer<SettingsWatcher> publisher(createWatcher(SettingsWatcher::Publisher));
+    QScopedPointer<SettingsWatcher> subscriber(createWatcher(SettingsWatcher::Subscriber));
+
+    QSignalSpy publisherSpy(publisher.data(), &SettingsWatcher::automaticLockingChanged);
+    QSignalSpy subscriberSpy(subscriber.data(), &SettingsWatcher::automaticLockingChanged);
+    QSignalSpy minimumLengthSpy(subscriber.data(), &SettingsWatcher::minimumLengthChanged);
+
+    writeSettings(10, 2);
+
+    QTRY_COMPARE(subscriber->automaticLocking, 10);
+    QCOMPARE(publisher->automaticLocking, 10);
+    QCOMPARE(publisherSpy.count(), 1);
+    QCOMPARE(subscriberSpy.count(), 1);
+    QCOMPARE(minimumLengthSpy.count(), 0);
+}
+
+void ut_settingswatcher::attemptRewriteIgnored()
+{
+    QScopedPointer<SettingsWatcher> publisher(createWatcher(SettingsWatcher::Publisher));
+    QScopedPointer<SettingsWatcher> subscriber(createWatcher(SettingsWatcher::Subscriber));
+
+    QSignalSpy publisherSpy(publisher.data(), &SettingsWatcher::currentAttemptsChanged);
+    QSignalSpy subscriberSpy(subscriber.data(), &SettingsWatcher::automaticLockingChanged);
+
+    // The plugin rewrites the file with every incorrect code, the daemon keeps its own count.
+    writeSettings(5, 3);
+    QTest::qWait(200);
+
+    QCOMPARE(publisher->currentAttempts, 2);
+    QCOMPARE(publisherSpy.count(), 0);
+    QCOMPARE(subscriberSpy.count(), 0);
+
+    // A change to anything else is still picked up after that.
+    writeSettings(10, 3);
+
+    QTRY_COMPARE(subscriber->automaticLocking, 10);
+    QCOMPARE(publisher->currentAttempts, 2);
+}
+
+void ut_settingswatcher::invalidSnapshotIgnored()
+{
+    QFile snapshot(m_snapshotDirectory + QStringLiteral("/settings"));
+    QVERIFY(snapshot.open(QIODevice::WriteOnly));
+    snapshot.write(QByteArray(4096, 'x'));
+    snapshot.close();
+
+    QScopedPointer<SettingsWatcher> subscriber(createWatcher(SettingsWatcher::Subscriber));
+
+    QCOMPARE(subscriber->automaticLocking, 5);
+    QCOMPARE(subscriber->minimumLength, 4);
+    QCOMPARE(subscriber->maximumAttempts, 3);
+
+    writeSettings(10, 2);
+
+    QTRY_COMPARE(subscriber->automaticLocking, 10);
+}
+
+void ut_settingswatcher::attemptsPersisted()
+{
+    QScopedPointer<SettingsWatcher> publisher(createWatcher(SettingsWatcher::Publisher));
+
+    QSignalSpy spy(publisher.data(), &SettingsWatcher::currentAttemptsChanged);
+
+    publisher->setCurrentAttempts(4);
+    QCOMPARE(publisher->currentAttempts, 4);
+    QCOMPARE(spy.count(), 1);
+
+    publisher.reset();
+
+    // Once there is saved state the count in the settings file is no longer used.
+    writeSettings(5, 1);
+
+    publisher.reset(createWatcher(SettingsWatcher::Publisher));
+    QCOMPARE(publisher->currentAttempts, 4);
+}
+
+QTEST_GUILESS_MAIN(ut_settingswatcher)
+
+#include "ut_settingswatcher.moc"
@@ -0,0 +1,6 @@
+TARGET = ut_settingswatcher
+
+include(../tests.pri)
+
+SOURCES = \
+        ut_settingswatcher.cpp